@@ -0,0 +1,61 @@
+/*
+ * ChildProcess.h
+ *
+ * Benchmarks of whole simulations are executed in forked processes,
+ * so the peak of resident memory belongs to one simulation only.
+ */
+
+#ifndef BENCH_CHILD_PROCESS_H_
+#define BENCH_CHILD_PROCESS_H_
+
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+// task is executed in child process and its returned message is passed to the parent through a pipe
+// returns 0 if child exited correctly, peak_rss_kb is peak of resident memory of the child in kB
+template<typename Task>
+int runInChild(Task task, std::string& message, long& peak_rss_kb){
+	int pipe_fd[2];
+	if(pipe(pipe_fd) != 0){
+		return 1;
+	}
+
+	pid_t pid = fork();
+	if(pid < 0){
+		return 1;
+	}
+	if(pid == 0){
+		close(pipe_fd[0]);
+		std::string to_send = task();
+		if(write(pipe_fd[1], to_send.c_str(), to_send.size()) < 0){
+			_exit(EXIT_FAILURE);
+		}
+		close(pipe_fd[1]);
+		_exit(EXIT_SUCCESS);
+	}
+	close(pipe_fd[1]);
+
+	message.clear();
+	char buffer[256];
+	ssize_t read_bytes;
+	while((read_bytes = read(pipe_fd[0], buffer, sizeof(buffer))) > 0){
+		message.append(buffer, read_bytes);
+	}
+	close(pipe_fd[0]);
+
+	int status = 0;
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+	// ru_maxrss is in bytes on OS X, in kilobytes on Linux
+#ifdef __APPLE__
+	peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+	peak_rss_kb = usage.ru_maxrss;
+#endif
+	return (WIFEXITED(status) and WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+#endif /* BENCH_CHILD_PROCESS_H_ */
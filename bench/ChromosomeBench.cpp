@@ -0,0 +1,16 @@
+/*
+ * ChromosomeBench.cpp
+ *
+ * recombination of a haploid chromosome with pure 'A' background (0D imigrants)
+ */
+
+void benchChromosome(BenchParameters par){
+	Context context(RANDOM_SEED);
+	Chromosome parent = makeChromosome(context, par.loci, par.junctions);
+	Chromosome recombinant;
+
+	BenchResult result = measure([&](){
+		parent.makeRecombinant(recombinant, context.random.poisson(par.lambda), context);
+	}, 1000);
+	report("Chromosome::makeRecombinant", par, result);
+}
@@ -0,0 +1,34 @@
+/*
+ * DemeBench.cpp
+ *
+ * breeding of one deme and computation of allele frequencies of one chromosome,
+ * deme is restored to the initial junction density before every measured Breed
+ */
+
+void benchDeme(BenchParameters par){
+	Context context(RANDOM_SEED);
+	std::vector<int> neigbours = {1, 2};
+	std::vector<Individual> founders;
+	founders.reserve(par.deme_size);
+	for(int i = 0; i < par.deme_size; i++){
+		founders.push_back(makeIndividual(context, 1, par.loci, par.junctions));
+	}
+	std::vector<SelectedLoci> selected_loci(1, SelectedLoci(par.loci, par.loci));
+	std::vector<RecombinationMap> recombination_maps; // uniform recombination
+	Deme deme(context, 0, neigbours, 'C', par.deme_size, 0.5, 1, 1, par.loci, selected_loci, par.lambda, recombination_maps, false, 0, 0);
+
+	BenchResult result = measure([&](){
+		deme.integrateMigrantVector(founders);
+	}, [&](){
+		deme.Breed();
+	}, 1);
+	report("Deme::Breed", par, result);
+
+	deme.integrateMigrantVector(founders);
+	std::vector<double> ps;
+	result = measure([&](){
+		ps.clear();
+		deme.getps(ps, 0);
+	}, 10);
+	report("Deme::getps", par, result);
+}
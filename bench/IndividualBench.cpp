@@ -0,0 +1,21 @@
+/*
+ * IndividualBench.cpp
+ *
+ * gametogenesis of a diploid individual with one chromosome, recombination of a batch of gametes
+ * is drawn in the setup as by a breeding deme
+ */
+
+void benchIndividual(BenchParameters par){
+	Context context(RANDOM_SEED);
+	Individual parent = makeIndividual(context, 1, par.loci, par.junctions);
+	std::vector<Chromosome> gamete;
+	PoissonTable chiasmata_table(par.lambda);
+	RecombinationBatch draws(chiasmata_table);
+
+	BenchResult result = measure([&](){
+		draws.draw(context.random, 1000, par.loci);
+	}, [&](){
+		parent.makeGamete<false, true>(gamete, nullptr, draws);
+	}, 1000);
+	report("Individual::makeGamete", par, result);
+}
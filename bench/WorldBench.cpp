@@ -0,0 +1,36 @@
+/*
+ * WorldBench.cpp
+ *
+ * migration in 4x4 reflexive 2D world after ten generations of burn in
+ */
+
+void benchWorld(BenchParameters par){
+	SimulationSetting setting;
+	setting.up_down_demes = 4;
+	setting.left_right_demes = 4;
+	setting.type_of_leftright_edges = "reflexive";
+	setting.type_of_updown_edges = "reflexive";
+	setting.dimension = 2;
+	setting.edges_per_deme = 4;
+	setting.selection = 0.5;
+	setting.beta = 1;
+	setting.lambda = par.lambda;
+	setting.selected_loci = par.loci;
+	setting.loci = par.loci;
+	setting.chromosomes = 1;
+	setting.deme_size = par.deme_size;
+	setting.seed = RANDOM_SEED;
+	setting.threads = 1;
+
+	World world(setting);
+	world.worldSlave();
+	for(int generation = 0; generation < 10; generation++){
+		world.migration();
+		world.globalBreeding();
+	}
+
+	BenchResult result = measure([&](){
+		world.migration();
+	}, 1);
+	report("World::migration", par, result);
+}
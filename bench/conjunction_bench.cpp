@@ -0,0 +1,174 @@
+/*
+ * Micro-benchmarks of the hot paths of the simulation.
+ * Every benchmark is run with the same fixed seed, results are streamed to
+ * the standard output as a tab separated table (one line per benchmark and
+ * combination of parameters), the progress is streamed to standard error.
+ */
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+#include "../include/RandomGenerators.h"
+#include "../include/Chromosome.h"
+#include "../include/Chiasmata.h"
+#include "../include/Imigrant.h"
+#include "../include/Individual.h"
+#include "../include/SelectionModel.h"
+#include "../include/Deme.h"
+#include "../include/World.h"
+#include "../include/SimulationSetting.h"
+#include "../include/AllocationCounter.h"
+
+const int RANDOM_SEED = 910401;
+// every benchmark runs at least this long (in seconds)
+const double MIN_TIME = 0.25;
+
+// // // // // // // // // // //
+// counting of heap allocations //
+// // // // // // // // // // //
+
+// builds with COUNT_ALLOCATIONS already count allocations in the simulator itself
+#ifndef COUNT_ALLOCATIONS
+static long allocation_count = 0;
+
+void* operator new(std::size_t size){
+	allocation_count++;
+	void *pointer = std::malloc(size == 0 ? 1 : size);
+	if(pointer == nullptr){
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+long allocationCount(){
+	return allocation_count;
+}
+#else
+long allocationCount(){
+	return AllocationCounter::count();
+}
+#endif
+
+// // // // // // //
+// bench harness //
+// // // // // // //
+
+struct BenchParameters {
+	int loci, deme_size, junctions;
+	double lambda;
+};
+
+struct BenchResult {
+	long ops, allocations;
+	double seconds;
+};
+
+// setup is called out of the measured time before every batch of ops
+template<typename Setup, typename Op>
+BenchResult measure(Setup setup, Op op, int batch){
+	BenchResult result{0, 0, 0};
+	while(result.seconds < MIN_TIME){
+		setup();
+		long allocations_before = allocationCount();
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+		for(int i = 0; i < batch; i++){
+			op();
+		}
+		std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+		result.allocations += allocationCount() - allocations_before;
+		result.seconds += std::chrono::duration<double>(t2 - t1).count();
+		result.ops += batch;
+	}
+	return result;
+}
+
+template<typename Op>
+BenchResult measure(Op op, int batch){
+	return measure([](){}, op, batch);
+}
+
+void printHeader(){
+	std::cout << "benchmark\tloci\tlambda\tdeme_size\tjunctions\tops\tns_per_op\tallocs_per_op\tops_per_s" << std::endl;
+}
+
+// deme size and junction density are not defined for every benchmark, NA is printed instead
+void report(std::string name, BenchParameters par, BenchResult result){
+	std::cout << name << '\t' << par.loci << '\t' << par.lambda << '\t';
+	if(par.deme_size > 0){ std::cout << par.deme_size; } else { std::cout << "NA"; }
+	std::cout << '\t';
+	if(par.junctions >= 0){ std::cout << par.junctions; } else { std::cout << "NA"; }
+	std::cout << '\t' << result.ops
+	<< '\t' << (result.seconds * 1e9) / result.ops
+	<< '\t' << double(result.allocations) / result.ops
+	<< '\t' << result.ops / result.seconds << std::endl;
+	std::cerr << name << " (loci " << par.loci << ", lambda " << par.lambda
+	<< ", deme " << par.deme_size << ", junctions " << par.junctions << ") ... done\n";
+}
+
+// chromosome with (up to) given number of junctions at random positions, starting by 'A'
+Chromosome makeChromosome(Context& context, int loci, int junctions){
+	Chromosome chromosome('A', loci);
+	std::map<int, char> positions;
+	if(junctions > loci - 1){
+		junctions = loci - 1;
+	}
+	while((int)positions.size() < junctions){
+		positions[context.random.recombPosition(loci)] = 'A';
+	}
+	char material = 'B';
+	for(std::map<int, char>::iterator pos = positions.begin(); pos != positions.end(); ++pos){
+		chromosome.write(pos->first, material);
+		material = (material == 'A') ? 'B' : 'A';
+	}
+	return chromosome;
+}
+
+Individual makeIndividual(Context& context, int chromosomes, int loci, int junctions){
+	std::vector<Chromosome> gamete1, gamete2;
+	for(int ch = 0; ch < chromosomes; ch++){
+		gamete1.push_back(makeChromosome(context, loci, junctions));
+		gamete2.push_back(makeChromosome(context, loci, junctions));
+	}
+	return Individual(gamete1, gamete2);
+}
+
+#include "ChromosomeBench.cpp"
+#include "IndividualBench.cpp"
+#include "DemeBench.cpp"
+#include "WorldBench.cpp"
+
+int main(int argc, char* argv[]){
+	std::cerr << "Running all benchmarks with random seed: " << RANDOM_SEED << std::endl;
+	printHeader();
+
+	const int loci_values[] = {100, 1000};
+	const double lambda_values[] = {1, 3};
+	const int deme_size_values[] = {64, 512};
+	const int junction_values[] = {0, 10, 100};
+
+	for(int loci : loci_values){
+		for(double lambda : lambda_values){
+			for(int junctions : junction_values){
+				benchChromosome(BenchParameters{loci, -1, junctions, lambda});
+				benchIndividual(BenchParameters{loci, -1, junctions, lambda});
+				for(int deme_size : deme_size_values){
+					benchDeme(BenchParameters{loci, deme_size, junctions, lambda});
+				}
+			}
+			for(int deme_size : deme_size_values){
+				benchWorld(BenchParameters{loci, deme_size, -1, lambda});
+			}
+		}
+	}
+
+	return 0;
+}
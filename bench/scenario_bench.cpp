@@ -0,0 +1,263 @@
+/*
+ * End-to-end benchmarks of canonical scenarios.
+ * Every scenario is a setting file (see bench/scenarios) simulated by Simulation::simulate
+ * in a separated process, so the peak of resident memory belongs to the scenario only.
+ * All output files and standard output of the simulation are written to a temporary directory
+ * and only their total size is reported.
+ *
+ * usage:
+ *	conjunction_scenarios [--baseline baseline.json] [--threshold 0.2] [--update baseline.json] scenario ...
+ *
+ * results are streamed to standard output as JSON (one scenario per line),
+ * if baseline is specified, scenarios slower or more memory demanding than
+ * baseline * (1 + threshold) are reported and the exit status is 1.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <stdexcept>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "ChildProcess.h"
+#include "../include/SimulationSetting.h"
+#include "../include/SettingHandler.h"
+#include "../include/Simulation.h"
+
+struct ScenarioResult {
+	std::string name;
+	double wall, setup, migration, breeding, saving;
+	long peak_rss_kb, output_bytes;
+};
+
+std::string scenarioName(const std::string& path){
+	size_t slash = path.find_last_of('/');
+	return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// executed in the child process, the returned times are passed to the parent
+std::string runScenario(const std::string& setting_file){
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	PhaseTimes total{0, 0, 0, 0};
+	double setup = 0;
+	int failed = 0;
+	try {
+		SettingHandler all_setting(setting_file);
+		SimulationSetting one_sim_setting;
+		for(int sim_index = 0; sim_index < all_setting.getNumberOfSimulations(); sim_index++){
+			std::chrono::steady_clock::time_point setup_start = std::chrono::steady_clock::now();
+			one_sim_setting = all_setting.getSimualtionSetting(sim_index);
+			Simulation sim(one_sim_setting);
+			setup += std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count();
+			if(sim.simulate() != 0){
+				failed = 1;
+				break;
+			}
+			PhaseTimes phase_times = sim.getPhaseTimes();
+			total.migration += phase_times.migration;
+			total.breeding += phase_times.breeding;
+			total.statistics += phase_times.statistics;
+			total.output += phase_times.output;
+		}
+	} catch(const std::runtime_error& exeption) {
+		failed = 1;
+	}
+	double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout.flush();
+
+	std::ostringstream message;
+	message << failed << ' ' << wall << ' ' << setup << ' '
+	<< total.migration << ' ' << total.breeding << ' ' << total.statistics + total.output;
+	return message.str();
+}
+
+// sums sizes of all files in directory and removes them together with the directory
+long collectOutput(const std::string& directory){
+	long bytes = 0;
+	DIR *dir = opendir(directory.c_str());
+	if(dir == nullptr){
+		return -1;
+	}
+	struct dirent *entry;
+	struct stat file_stat;
+	while((entry = readdir(dir)) != nullptr){
+		std::string file = directory + "/" + entry->d_name;
+		if(stat(file.c_str(), &file_stat) == 0 and S_ISREG(file_stat.st_mode)){
+			bytes += file_stat.st_size;
+			unlink(file.c_str());
+		}
+	}
+	closedir(dir);
+	rmdir(directory.c_str());
+	return bytes;
+}
+
+int benchScenario(const std::string& path, ScenarioResult& result){
+	char absolute_path[PATH_MAX];
+	if(realpath(path.c_str(), absolute_path) == nullptr){
+		std::cerr << "Can not find scenario: " << path << std::endl;
+		return 1;
+	}
+	char directory[] = "/tmp/conjunction_scenario_XXXXXX";
+	if(mkdtemp(directory) == nullptr){
+		std::cerr << "Can not create temporary directory for outputs." << std::endl;
+		return 1;
+	}
+
+	std::string message;
+	int status = runInChild([&]() -> std::string {
+		if(chdir(directory) != 0 or
+		   freopen("stdout.txt", "w", stdout) == nullptr or
+		   freopen("/dev/null", "w", stderr) == nullptr){
+			_exit(EXIT_FAILURE);
+		}
+		return runScenario(absolute_path);
+	}, message, result.peak_rss_kb);
+
+	result.name = scenarioName(path);
+	result.output_bytes = collectOutput(directory);
+
+	int failed = 1;
+	std::istringstream parsed(message);
+	parsed >> failed >> result.wall >> result.setup >> result.migration >> result.breeding >> result.saving;
+	if(status != 0 or parsed.fail() or failed){
+		std::cerr << "Scenario " << result.name << " has failed." << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+std::string toJSON(const ScenarioResult& result){
+	std::ostringstream json;
+	json << "{\"name\": \"" << result.name << "\""
+	<< ", \"wall_s\": " << result.wall
+	<< ", \"setup_s\": " << result.setup
+	<< ", \"migration_s\": " << result.migration
+	<< ", \"breeding_s\": " << result.breeding
+	<< ", \"saving_s\": " << result.saving
+	<< ", \"peak_rss_kb\": " << result.peak_rss_kb
+	<< ", \"output_bytes\": " << result.output_bytes << "}";
+	return json.str();
+}
+
+// the value of numerical field in one line JSON object, -1 if missing
+double fieldOf(const std::string& line, const std::string& key){
+	size_t pos = line.find("\"" + key + "\":");
+	if(pos == std::string::npos){
+		return -1;
+	}
+	return atof(line.c_str() + pos + key.size() + 3);
+}
+
+// baseline is expected in the format produced by this binary (one scenario per line)
+bool findInBaseline(const std::vector<std::string>& baseline, const std::string& name, std::string& line){
+	for(unsigned int i = 0; i < baseline.size(); i++){
+		if(baseline[i].find("\"name\": \"" + name + "\"") != std::string::npos){
+			line = baseline[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+int compareToBaseline(const ScenarioResult& result, const std::vector<std::string>& baseline, double threshold){
+	std::string line;
+	if(!findInBaseline(baseline, result.name, line)){
+		std::cerr << result.name << ": not in the baseline" << std::endl;
+		return 0;
+	}
+	int regressions = 0;
+	double base_wall = fieldOf(line, "wall_s");
+	double base_rss = fieldOf(line, "peak_rss_kb");
+	double base_output = fieldOf(line, "output_bytes");
+	if(base_wall > 0 and result.wall > base_wall * (1 + threshold)){
+		std::cerr << result.name << ": REGRESSION of wall time " << base_wall << " s -> " << result.wall << " s" << std::endl;
+		regressions++;
+	}
+	if(base_rss > 0 and result.peak_rss_kb > base_rss * (1 + threshold)){
+		std::cerr << result.name << ": REGRESSION of peak RSS " << base_rss << " kB -> " << result.peak_rss_kb << " kB" << std::endl;
+		regressions++;
+	}
+	if(base_output >= 0 and result.output_bytes != (long)base_output){
+		std::cerr << result.name << ": warning, size of output has changed " << base_output << " B -> " << result.output_bytes << " B" << std::endl;
+	}
+	if(regressions == 0){
+		std::cerr << result.name << ": wall " << result.wall << " s (baseline " << base_wall << " s) ... passed" << std::endl;
+	}
+	return regressions;
+}
+
+int main(int argc, char* argv[]){
+	std::string baseline_file, update_file;
+	double threshold = 0.2; // as THRESHOLD of the Makefile
+	std::vector<std::string> scenarios;
+
+	for(int i = 1; i < argc; i++){
+		if(strcmp(argv[i], "--baseline") == 0 and i + 1 < argc){
+			baseline_file = argv[++i];
+		} else if(strcmp(argv[i], "--update") == 0 and i + 1 < argc){
+			update_file = argv[++i];
+		} else if(strcmp(argv[i], "--threshold") == 0 and i + 1 < argc){
+			threshold = atof(argv[++i]);
+		} else {
+			scenarios.push_back(argv[i]);
+		}
+	}
+
+	std::vector<std::string> baseline;
+	if(!baseline_file.empty()){
+		std::ifstream baseline_stream(baseline_file);
+		if(!baseline_stream){
+			std::cerr << "Can not open baseline: " << baseline_file << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::string line;
+		while(getline(baseline_stream, line)){
+			baseline.push_back(line);
+		}
+	}
+
+	std::vector<std::string> lines;
+	int regressions = 0, failures = 0;
+	ScenarioResult result;
+	for(unsigned int i = 0; i < scenarios.size(); i++){
+		std::cerr << "Running scenario " << scenarios[i] << " ..." << std::endl;
+		if(benchScenario(scenarios[i], result) != 0){
+			failures++;
+			continue;
+		}
+		lines.push_back(toJSON(result));
+		if(!baseline.empty()){
+			regressions += compareToBaseline(result, baseline, threshold);
+		}
+	}
+
+	std::ostringstream json;
+	json << "{\"scenarios\": [\n";
+	for(unsigned int i = 0; i < lines.size(); i++){
+		json << lines[i] << (i + 1 < lines.size() ? ",\n" : "\n");
+	}
+	json << "]}\n";
+	std::cout << json.str();
+
+	if(!update_file.empty()){
+		std::ofstream update_stream(update_file);
+		update_stream << json.str();
+		std::cerr << "Baseline saved to: " << update_file << std::endl;
+	}
+
+	if(failures + regressions > 0){
+		std::cerr << failures << " scenario/s failed, " << regressions << " regression/s over threshold " << threshold << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
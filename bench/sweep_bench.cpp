@@ -0,0 +1,97 @@
+/*
+ * Scaling sweeps over the parameters of simulation.
+ * Every sweep is an ordinary setting file, the grid of configurations is defined
+ * by vector parameters (i.e. DEMEsize = [64, 256, 1024]) and expanded by SettingHandler
+ * in the same way as for simulations. Different worlds are defined in separated sweep files.
+ * Every configuration is simulated in a separated process (no output is saved),
+ * the results are streamed to standard output as CSV (one line per configuration).
+ *
+ * usage:
+ *	conjunction_sweep sweep_setting ...
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "ChildProcess.h"
+#include "../include/World.h"
+#include "../include/SimulationSetting.h"
+#include "../include/SettingHandler.h"
+
+void printHeader(){
+	std::cout << "sweep,dimension,columns,rows,deme_size,loci,chromosomes,lambda,threads,generations,"
+	<< "seconds_per_generation,individuals_per_second,peak_rss_kb,junctions_per_individual" << std::endl;
+}
+
+// executed in the child process, returns "seconds individuals junctions"
+std::string runConfiguration(const SimulationSetting& setting){
+	World world(setting);
+	world.restart();
+	double bred_individuals = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int generation = 0; generation < setting.generations; generation++){
+		world.migration();
+		world.globalBreeding();
+		bred_individuals += world.getNumberOfIndividuals();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::ostringstream message;
+	message << seconds << ' ' << bred_individuals << ' ' << world.getMeanNumberOfJunctions();
+	return message.str();
+}
+
+int sweep(const std::string& sweep_file){
+	SettingHandler all_setting(sweep_file);
+	SimulationSetting setting;
+	std::string message;
+	long peak_rss_kb = 0;
+	int failures = 0;
+	for(int sim_index = 0; sim_index < all_setting.getNumberOfSimulations(); sim_index++){
+		setting = all_setting.getSimualtionSetting(sim_index);
+		std::cerr << "Sweep " << sweep_file << ": configuration " << sim_index + 1
+		<< " / " << all_setting.getNumberOfSimulations() << std::endl;
+		int status = runInChild([&]() -> std::string {
+			if(freopen("/dev/null", "w", stderr) == nullptr){
+				_exit(EXIT_FAILURE);
+			}
+			return runConfiguration(setting);
+		}, message, peak_rss_kb);
+
+		double seconds = 0, individuals = 0, junctions = 0;
+		std::istringstream parsed(message);
+		parsed >> seconds >> individuals >> junctions;
+		if(status != 0 or parsed.fail()){
+			std::cerr << "Configuration " << sim_index + 1 << " has failed." << std::endl;
+			failures++;
+			continue;
+		}
+		std::cout << sweep_file << ',' << setting.dimension << ','
+		<< (setting.dimension > 0 ? setting.left_right_demes : 0) << ','
+		<< (setting.dimension > 0 ? setting.up_down_demes : 0) << ','
+		<< setting.deme_size << ',' << setting.loci << ',' << setting.chromosomes << ','
+		<< setting.lambda << ',' << setting.threads << ',' << setting.generations << ','
+		<< seconds / setting.generations << ',' << individuals / seconds << ','
+		<< peak_rss_kb << ',' << junctions << std::endl;
+	}
+	return failures;
+}
+
+int main(int argc, char* argv[]){
+	int failures = 0;
+	printHeader();
+	try {
+		for(int i = 1; i < argc; i++){
+			failures += sweep(argv[i]);
+		}
+	} catch(const std::runtime_error& exeption) {
+		std::cerr << "ERROR: " << exeption.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
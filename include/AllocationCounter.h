@@ -0,0 +1,16 @@
+/*
+ * AllocationCounter.h
+ *
+ * opt-in counting of heap allocations, the global operator new is replaced
+ * only in builds with COUNT_ALLOCATIONS defined (make COUNT_ALLOCATIONS=1)
+ */
+
+#ifndef INCLUDE_ALLOCATIONCOUNTER_H_
+#define INCLUDE_ALLOCATIONCOUNTER_H_
+
+namespace AllocationCounter {
+	bool enabled();
+	long count(); // allocations of all threads since the start of the program, 0 if not counted
+}
+
+#endif /* INCLUDE_ALLOCATIONCOUNTER_H_ */
@@ -3,24 +3,40 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
+#include "../include/Position.h"
+
+// sorted positions of chiasmata of one chromosome of a gamete, recorded only for backtrace,
+// a few chiasmata are stored inline, the heap is used only by chromosomes with many of them
 class Chiasmata
 {
 	public :
 /* INITIATION */
 		Chiasmata(); // no recombination - empty vector
-		Chiasmata(std::vector<int> input_chiasmata);
+		Chiasmata(const std::vector<int>& input_chiasmata);
+		Chiasmata(const int* first, const int* last); // sorted positions
+		Chiasmata(const Chiasmata& other);
+		Chiasmata& operator=(const Chiasmata& other);
 		~Chiasmata();
 
 /* COMUNICATION METHODS */
 		int length() const;
 		int get(int index) const;
-		void set(std::vector<int> input_chiasmata);
+		void set(const std::vector<int>& input_chiasmata);
 		void add(int chiasma);
 		std::string collapse() const;
+		double getMemoryUsage() const; // bytes of the object and recorded positions
 
 	protected:
-		std::vector <int> chiasmata;
+		static const int INLINE_CHIASMATA = 8;
+		Position* positions(); // inline buffer or spilled array
+		const Position* positions() const;
+		void reserve(int capacity);
+
+		Position inline_chiasmata[INLINE_CHIASMATA];
+		std::unique_ptr<Position[]> spilled; // nullptr if chiasmata fit the inline buffer
+		int number_of_chiasmata, capacity;
 };
 
 #endif
@@ -5,6 +5,9 @@
 #include <vector>
 
 #include "../include/Context.h"
+#include "../include/JunctionArena.h"
+#include "../include/RecombinationMap.h"
+#include "../include/SelectedLoci.h"
 
 class Chromosome
 {
@@ -12,7 +15,7 @@ class Chromosome
 /* INITIATION */
 		Chromosome(); /* blank chromosome is used for recombination*/
 		Chromosome(char starting_char, int size);
-		Chromosome(std::map <int, char> input_chrom, int size);
+		Chromosome(const Junctions& input_chrom, int size);
 		~Chromosome();
 
 /* PLOTTING METHODS */
@@ -23,25 +26,48 @@ class Chromosome
 		bool isPureB() const; /*returns 1 if there are only B, 0 in other case*/
 		int countB() const; /*returns number of B loci in chromosome*/
 		int countB(int selectedB) const; /*returns number of B loci in chromosome*/
+		/* genotype of selected loci packed by bits, it follows the chromosome through recombination once packed,
+		   chromosomes with more than 64 selected loci are not packed */
+		void packSelected(const SelectedLoci& selected);
+		bool isPacked() const; /*returns 0 if the chromosome was changed since it was packed*/
+		int countSelectedB(const SelectedLoci& selected) const; /*returns number of B selected loci*/
 		int getNumberOfJunctions() const; /*returns number of Junctions in chromosome*/
+		double getMemoryUsage() const; /*returns estimated bytes of the chromosome including junctions*/
 		void getSizesOfBBlocks(std::vector<int>& sizes); /*fills vector of ints by sizes of B blocks in chromosome*/
+		void addBBlocks(int* difference, int weight) const; /*adds weight to B loci of a difference array of loci + 1 values*/
+		void addJunctionPositions(long long* counts, int bins, int weight) const; /*adds weight to bins of positions of junctions*/
 		void getSizesOfABlocks(std::vector<int>& sizes);
 		void getSizesOfBlocks(std::vector<int>& sizes) const;
 		void makeRecombinant(Chromosome& chromNew,int numberOfChaisma, const Context &context);
+		bool makeRecombinant(Chromosome& chromNew,int numberOfChaisma, RandomGenerator& random); /*returns 1 if chromNew is inherited copy*/
+		/* recombination in two steps, positions of chiasmata are drawn first, recombinant is written only if needed */
+		void drawRecombination(std::vector<int>& recombination, int numberOfChaisma, RandomGenerator& random) const;
+		void drawRecombination(std::vector<int>& recombination, int numberOfChaisma, RandomGenerator& random, const RecombinationMap* map) const; // uniform if nullptr
+		bool inheritsB(const std::vector<int>& recombination, int starts_by) const; /*returns 1 if the recombinant would contain B*/
+		void writeRecombinant(Chromosome& chromNew, const std::vector<int>& recombination, int starts_by) const;
+		/* recombinant of two parental chromosomes, recombination are sorted positions of chiasmata,
+		   selected loci of recombinant are packed if they are given and both parents are packed */
+		static void writeRecombinant(Chromosome& chromNew, const Chromosome& parent1, const Chromosome& parent2,
+				const int* recombination, int numberOfChaisma, int starts_by, const SelectedLoci* selected = nullptr);
 
 /* COMUNICATION METHODS */
 		void setResolution(int res);
 		int getResolution() const; /* return resolution of the chromosome */
 		void clear(); /* method for deleting chromosome */
-		char read(int i); /* returns value of junction */
+		char read(int i); /* returns material of locus i */
 		void write(int i, char l); /* makes new junction*/
-		std::map<int, char>::iterator begin();
-		std::map<int, char>::iterator end();
-		std::map<int, char>::iterator find(int i);
+		Junctions::iterator begin();
+		Junctions::iterator end();
+		Junctions::iterator find(int i);
 
 	protected:
-		std::map <int, char> chromosome;
+		static void mergeRecombinant(Junctions& recombinant, const Junction* const first[2], const Junction* const last[2],
+				const int* recombination, int numberOfChaisma, int starts_by);
+
+		Junctions chromosome; // sorted by position, allocated in the arena of the generation (if any)
+		uint64_t selected_genotype; // B of selected loci by bits if packed
 		int loci;
+		bool packed;
 };
 
 #endif
@@ -5,16 +5,20 @@
 #define DEME_H
 
 #include <vector>
+#include <cstdint>
 
 #include "../include/Individual.h"
 #include "../include/SelectionModel.h"
 #include "../include/Context.h"
+#include "../include/JunctionArena.h"
+#include "../include/RecombinationBatch.h"
+#include "../include/TractHistogram.h"
 
 class Deme
 {
 	public:
 // constructor / destructors
-		Deme(const Context& context, int ind, std::vector<int> neigb, char init, int size, double sel, double beta, int in_ch, int in_loc, int in_sel_loci, double in_lambda, int in_x, int in_y);
+		Deme(const Context& context, int ind, std::vector<int> neigb, char init, int size, double sel, double beta, int in_ch, int in_loc, const std::vector<SelectedLoci>& in_selected, double in_lambda, const std::vector<RecombinationMap>& in_maps, bool in_pedigree, int in_x, int in_y);
 		~Deme();
 
 // communication functions
@@ -34,6 +38,8 @@ class Deme
 		//void getJunctionNumbers(std::vector<double>& juncs) const;
 		//void getHeterozygoty(std::vector<double>& heterozs);
 		double getMeanBproportion() const;
+		double getMeanNumberOfJunctions();
+		void addMemoryUsage(MemoryUsage& usage) const;
 		//void getSizesOfBBlocks(std::vector<int>& sizes, int ind);
 		//void getSizesOfABlocks(std::vector<int>& sizes, int ind);
 		double getProportionOfHomozygotes(char population) const;
@@ -42,9 +48,18 @@ class Deme
 		double getMeanFitness();
 		double getVARhi() const;
 		double getVARp();
-		void getps(std::vector<double>& ps, int ch);
+		void getps(std::vector<double>& ps, int ch) const; // B frequencies of loci of the chromosome
 		double getLD();
 		double getLD(double z,double varz,double varp);
+		// haplotypes of the chromosome as columns of bits of every locus (words per locus) and B frequencies of loci
+		int getHaplotypeColumns(std::vector<uint64_t>& columns, std::vector<double>& ps, int ch);
+		// pairwise linkage disequilibrium of the locus i with every locus j (at j) from the haplotype columns,
+		// a row at a time, so the memory does not grow with the square of the number of loci
+		void getPairwiseLD(std::vector<double>& D, std::vector<double>& r2, const std::vector<uint64_t>& columns,
+				const std::vector<double>& ps, int words, int i) const;
+		void addTracts(TractHistogram& a_tracts, TractHistogram& b_tracts); // tracts of all individuals
+		// junctions of all individuals in bins of positions of every chromosome (bins values per chromosome)
+		void getJunctionDensity(std::vector<long long>& counts, int bins) const;
 
 // plotting functions
 		void showDeme();
@@ -54,26 +69,49 @@ class Deme
 		void streamHIs(std::ostream& stream) const;
 		void streamJunctions(std::ostream& stream) const;
 		void streamHeterozygosity(std::ostream& stream) const;
+		void streamLinkage(std::ostream& stream);
+		void streamTracts(std::ostream& stream);
+		void streamJunctionDensity(std::ostream& stream, int bins) const;
 
 
 		void readAllGenotypes();
 		void readGenotypeFrequencies();
 
 	private:
-		const Context& context;
+		Context context; // own generator of random numbers, demes can be bred in parallel
 
 		int pickAnIndividual();
-		static int sum(std::vector<bool>& ve);
 		template<typename T>
 		int streamLine(std::ostream& stream, std::vector<T>& vec) const;
 		double roundForPrint(double number) const;
+		// kernels specialised on the mode of the world, picked by the constructor
+		template <bool RECORD_PEDIGREE, bool RECOMBINATION>
+		void breedOffspring(Individual *metademe, const std::vector<int>& mothers, const std::vector<int>& fathers);
+		template <bool ALL_LOCI_SELECTED>
+		void fillFitnessVector(std::vector<double>& fitnessVector);
+		void rebuildBProfile();
 
 		Individual *deme; // farme of individuals
+		// junctions of parents and of offspring, an arena is released when its generation is replaced
+		JunctionArena arenas[2];
+		int current_arena; // arena of the living generation
 		int index; // index of deme in universe
 		int x, y;
 		int deme_size; // size of deme
 		std::vector<int> neigbours; // indices of neigbours
 		SelectionModel selection_model;
+		const std::vector<SelectedLoci>& selected_loci; // kept by the world, loci under selection of every chromosome
+		const double lambda;
+		const bool record_pedigree; // birthplaces of individuals and of their parents are kept for backtrace
+		const PoissonTable chiasmata_table; // numbers of chiasmata are drawn by its inversion
+		const std::vector<RecombinationMap>& recombination_maps; // kept by the world, empty if recombination is uniform
+		void (Deme::*offspring_kernel)(Individual *metademe, const std::vector<int>& mothers, const std::vector<int>& fathers);
+		void (Deme::*fitness_kernel)(std::vector<double>& fitnessVector);
+		const std::vector<SelectedLoci> *packed_loci; // selected loci packed in chromosomes, nullptr if all loci are selected
+		// B counts of loci of every chromosome kept as a difference array (loci + 1 values per chromosome),
+		// rebuilt from B blocks of offspring and updated by blocks of migrants and of the individuals they replace
+		std::vector<int> b_profile;
+		const int number_of_loci;
 };
 
 #endif
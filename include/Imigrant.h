@@ -5,27 +5,51 @@
 
 #include "../include/Chromosome.h"
 #include "../include/Context.h"
+#include "../include/MemoryUsage.h"
+
+// chiasmata of one chromosome of a gamete drawn before the gamete is written
+struct Recombination {
+	std::vector<int> positions;
+	int starts_by; // 1 if the gamete starts by the chromosome of imigrant, 0 by 'A'
+};
 
 class Imigrant
 {
 	public:
 		/* DECLARATION */
-		Imigrant(const Context &context, int input_ch, int size, double input_lambda);
+		Imigrant(); /* blank imigrant is a reusable slot of the pool */
+		/* recombination follows genetic maps of chromosomes if given (nullptr is uniform), offspring inherit them */
+		Imigrant(const Context &context, int input_ch, int size, double input_lambda, const std::vector<RecombinationMap>* input_maps = nullptr);
 		/* init Individual as 'A', 'B' or pure "AB" heterozygot*/
-		Imigrant(const Context &context, char origin, int input_ch, int size, double input_lambda);
+		Imigrant(const Context &context, char origin, int input_ch, int size, double input_lambda, const std::vector<RecombinationMap>* input_maps = nullptr);
 		/*init Individual by gametes on imput */
-		Imigrant(const Context &context, std::vector<Chromosome>& gamete, double input_lambda);
+		Imigrant(const Context &context, std::vector<Chromosome>& gamete, double input_lambda, const std::vector<RecombinationMap>* input_maps = nullptr);
+		Imigrant(const Imigrant& orig) = default;
+		Imigrant(Imigrant&& orig) = default;
+		Imigrant& operator=(const Imigrant& orig) = default; /* storage of the assigned imigrant is reused */
+		Imigrant& operator=(Imigrant&& orig) = default;
 		~Imigrant(); /* destructor */
 
 		/* COMPUTIONG METHODS */
 		int getChiasma();
 		void makeGamete(std::vector<Chromosome>& gamete);
+		bool makeGamete(std::vector<Chromosome>& gamete, RandomGenerator& random); // returns 1 if all chromosomes are inherited copies
+		/* gamete in two steps, pure 'A' gametes can be rejected before they are written */
+		void drawRecombination(std::vector<Recombination>& recombination, RandomGenerator& random) const;
+		bool isCopy(const std::vector<Recombination>& recombination) const; // no chiasma and imigrant's chromosomes only
+		bool carriesB(const std::vector<Recombination>& recombination) const;
+		void writeGamete(std::vector<Chromosome>& gamete, const std::vector<Recombination>& recombination) const;
+		void inherit(const Imigrant& parent, const std::vector<Recombination>& recombination); /* writes the gamete of parent in place */
 
 		void getSizesOfBBlocks(std::vector<int>& sizes);
+		void getSizesOfABlocks(std::vector<int>& sizes);
+		// junctions are added copies times to bins of positions of chromosomes (bins values per chromosome)
+		void addJunctionPositions(std::vector<long long>& counts, int bins, int copies) const;
 
 		/* STATS */
 		int getNumberOfBBlocks();
 		int getNumberOfJunctions() const;
+		void addMemoryUsage(MemoryUsage& usage) const;
 
 		double getBprop() const;
 		bool isPureA() const;
@@ -38,10 +62,11 @@ class Imigrant
 		void readGenotype();
 
 	private:
-		const Context &context;
+		const Context *context;
 		std::vector<Chromosome> genome;
 		int number_of_chromosomes;
 		double lambda;
+		const std::vector<RecombinationMap> *recombination_maps;
 };
 
 
@@ -0,0 +1,54 @@
+/*
+ * ImigrantPool.h
+ *
+ * generation buffer of 0D simulation, imigrants of the previous generations are kept
+ * as reusable slots, therefore the pool is not reallocated every generation
+ */
+
+#ifndef INCLUDE_IMIGRANTPOOL_H_
+#define INCLUDE_IMIGRANTPOOL_H_
+
+#include <vector>
+
+#include "../include/Imigrant.h"
+#include "../include/MemoryUsage.h"
+
+// sums over all imigrants of the pool (every imigrant is counted as many times as its copies)
+struct PoolStatistics {
+	int individuals;
+	double material; // sum of proportions of B
+	int b_blocks;
+	double fitness;
+	double junctions;
+};
+
+class ImigrantPool {
+	public:
+		ImigrantPool();
+
+		int size() const; // number of distinct imigrants
+		Imigrant& operator[](int index);
+		const Imigrant& operator[](int index) const;
+		int getCopies(int index) const;
+		double getFitness(int index) const;
+
+		Imigrant& push(int copies); // next slot of the pool (its content is undefined)
+		void push(const Imigrant& imigrant, int copies);
+		void setFitness(int index, double imigrant_fitness);
+		void addCopies(int index, int copies);
+		void take(ImigrantPool& other, int index); // imigrant of other is exchanged for a reusable slot of this pool
+		// as take, but all pure B imigrants taken are merged to one entry holding their copies (weighted pool)
+		void takeMerged(ImigrantPool& other, int index);
+		void clear(); // all imigrants become reusable slots
+
+		void addMemoryUsage(MemoryUsage& usage) const;
+
+	private:
+		std::vector<Imigrant> imigrants; // [0, filled) is the pool, the rest are reusable slots
+		std::vector<int> copies; // number of copies of every imigrant (1 if pool is not weighted)
+		std::vector<double> fitness; // computed once when the imigrant enters the pool
+		int filled;
+		int pure_b; // entry of merged pure B imigrants, -1 if none was taken
+};
+
+#endif /* INCLUDE_IMIGRANTPOOL_H_ */
@@ -4,49 +4,62 @@
 #include <map>
 #include <vector>
 #include <tuple>
+#include <memory>
 
 #include "../include/Chromosome.h"
 #include "../include/Chiasmata.h"
-#include "../include/Context.h"
+#include "../include/RandomGenerators.h"
+#include "../include/RecombinationBatch.h"
+#include "../include/MemoryUsage.h"
 
 class Individual
 {
 	public:
 /* DECLARATION */
 		Individual();
-		Individual(const Context *context, char origin, int input_ch, int input_loci, double input_lamda, int input_selected_loci, std::tuple<int, int, int> ind_birthplace);
-		Individual(const Context *context, std::vector<Chromosome>& gamete1, std::vector<Chiasmata>& chaiasmata1,
-					std::vector<Chromosome>& gamete2, std::vector<Chiasmata>& chaiasmata2,
-					double input_lamda, int input_selected_loci,
-					std::tuple<int, int, int> ind_birthplace); /*init Individual by gametes on imput */
+		Individual(char origin, int input_ch, int input_loci);
+		Individual(std::vector<Chromosome>& gamete1, std::vector<Chromosome>& gamete2); /*init Individual by gametes on imput */
 		~Individual(); /* destructor */
 
 /* COMPUTIONG METHODS */
-		void replace_chromozome(int set, int position,std::map <int, char> input_chrom, int size);
-		void makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>& chiasmata);
+		void replace_chromozome(int set, int position,const Junctions& input_chrom, int size);
+		// lambda (expected number of chiasmata per chromosome) is the same in the whole world, so it is kept by the deme
+		void makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>* chiasmata, double lambda, RandomGenerator& random);
+		// kernel specialised on recording of chiasmata and on recombination (lambda > 0), instantiated for all four cases,
+		// draws of recombination of the chromosomes are taken from the batch, selected loci of packed chromosomes
+		// are packed in the gamete if the selected loci of chromosomes are given
+		template <bool RECORD_CHIASMATA, bool RECOMBINATION>
+		void makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>* chiasmata, RecombinationBatch& draws,
+				const std::vector<SelectedLoci>* selected_loci = nullptr);
 		int getBcount() const;
 		double getBprop() const;
-		double getSelectedHybridIndex();
+		// selected loci of every chromosome, chromosomes are packed if they are not yet
+		double getSelectedHybridIndex(const std::vector<SelectedLoci>& selected_loci);
 		double getHetProp();
 		bool isPureA() const;
 		bool isPureB() const;
-		std::map<int, char>::iterator getChromosomeBegining(int set, int chrom);
+		Junctions::iterator getChromosomeBegining(int set, int chrom);
 		int getNumberOfJunctions(int set, int chrom);
 		int getNumberOfJunctions();
+		void addMemoryUsage(MemoryUsage& usage) const;
 		void getSizesOfBBlocks(std::vector<int>& sizes);
+		// B loci of both sets are added to the difference arrays of chromosomes (loci + 1 values per chromosome)
+		void addBBlocks(std::vector<int>& difference, int weight) const;
+		// junctions of both sets are added to bins of positions of chromosomes (bins values per chromosome)
+		void addJunctionPositions(std::vector<long long>& counts, int bins) const;
 		void getSizesOfABlocks(std::vector<int>& sizes);
 
 /* ASCII PLOTTING METHODS */
 		void readGenotype();
 
 /* COMUNICATION */
-		void setNumberOfChromosomes(int ch);
-		void setLambda(double Rr);
-		void setParents(std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad);
+		void setPedigree(std::tuple<int,int,int> in_birthplace,
+						 std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad);
+		void setPedigree(std::tuple<int,int,int> in_birthplace,
+						 std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad,
+						 const std::vector<Chiasmata>& chiasmata1, const std::vector<Chiasmata>& chiasmata2);
 		int getNumberOfChromosomes() const;
-		double getLambda() const;
 		int getNumberOfLoci(int ch) const;
-		int getNumberOfSelectedLoci() const;
 		void getNumberOfLoci(std::vector<int>& ch) const;
 		void getGenotype(std::vector<std::string>& hapl) const;
 		void getChiasmata(std::vector<std::string>& rec) const;
@@ -55,17 +68,19 @@ class Individual
 		std::tuple<int,int,int> getDad() const;
 
 	private:
-		const Context *context;
+		struct Pedigree {
+			// cartesian x, y of deme indeces and index of ind within the deme
+			std::tuple<int,int,int> birthplace, mum, dad;
+			std::vector<Chiasmata> chiasmata; // of both gametes in the order of genome, empty for founders
+		};
 	/*data*/
-		std::vector<Chromosome> genome[2];
-		std::vector<Chiasmata> chiasmata[2];
-		int number_of_chromosomes, selected_loci;
-		double lambda;
-		// cartesian x, y of deme indeces and index of ind within the deme
-		std::tuple<int,int,int> birthplace, mum, dad;
+		std::vector<Chromosome> genome; // both sets of chromosomes, the second set follows the first one
+		std::shared_ptr<const Pedigree> pedigree; // recorded only if the backtrace is saved, copies share it
 
 	/*inner functions*/
-		int getOneChromeHetero(bool write, std::map<int, char>::const_iterator& pos, int chromosome, int last_pos);
+		Chromosome& getChromosome(int set, int chrom);
+		const Chromosome& getChromosome(int set, int chrom) const;
+		int getOneChromeHetero(bool write, Junctions::const_iterator& pos, int chromosome, int last_pos);
 		std::string collapseBlocks(std::vector<int>& blocks) const;
 };
 
@@ -0,0 +1,104 @@
+/*
+ * JunctionArena.h
+ *
+ * bump allocator owning junctions of chromosomes of one generation of a deme,
+ * all junctions of the generation are released at once by reset and its blocks
+ * are reused by other arenas
+ *
+ * junctions of a chromosome are a sorted array of (position, material) pairs
+ */
+
+#ifndef INCLUDE_JUNCTIONARENA_H_
+#define INCLUDE_JUNCTIONARENA_H_
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+#include "../include/Position.h"
+
+class JunctionArena {
+	public:
+		JunctionArena();
+		~JunctionArena();
+		JunctionArena(const JunctionArena&) = delete;
+		JunctionArena& operator=(const JunctionArena&) = delete;
+
+		void* allocate(std::size_t bytes);
+		void deallocate(void* pointer, std::size_t bytes); // small arrays are reused within the generation
+		void reset(); // all junctions are released
+
+		// arena of the calling thread, junctions created by the thread are allocated there (nullptr is heap)
+		static JunctionArena* active();
+
+		// the arena is active for the calling thread as long as the scope lives
+		class Scope {
+			public:
+				explicit Scope(JunctionArena* arena);
+				~Scope();
+			private:
+				JunctionArena *previous;
+		};
+
+	private:
+		struct FreeNode {
+			FreeNode *next;
+		};
+		static const int SIZE_CLASSES = 64; // freed arrays up to 64 words are reused
+
+		std::vector<char*> blocks; // the last one is being filled
+		std::vector<void*> large; // allocations that do not fit a block
+		std::size_t used; // bytes used in the last block
+		FreeNode *free_arrays[SIZE_CLASSES]; // freed arrays of every size (in words)
+};
+
+// junctions are allocated in the arena active when the chromosome was created, copies are created
+// in the arena active at the moment of copying, assignment keeps the arena of the assigned chromosome
+template <typename T>
+struct JunctionAllocator {
+	typedef T value_type;
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	JunctionAllocator() : arena{JunctionArena::active()} {}
+	template <typename U>
+	JunctionAllocator(const JunctionAllocator<U>& other) : arena{other.arena} {}
+
+	T* allocate(std::size_t n){
+		if(arena == nullptr){
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		return static_cast<T*>(arena->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* pointer, std::size_t n){
+		if(arena == nullptr){
+			::operator delete(pointer);
+		} else {
+			arena->deallocate(pointer, n * sizeof(T));
+		}
+	}
+
+	JunctionAllocator select_on_container_copy_construction() const{
+		return JunctionAllocator();
+	}
+
+	JunctionArena *arena;
+};
+
+template <typename T, typename U>
+bool operator==(const JunctionAllocator<T>& a, const JunctionAllocator<U>& b){
+	return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const JunctionAllocator<T>& a, const JunctionAllocator<U>& b){
+	return a.arena != b.arena;
+}
+
+typedef std::pair<Position, char> Junction; // position and the material from the position on
+typedef std::vector<Junction, JunctionAllocator<Junction> > Junctions;
+
+#endif /* INCLUDE_JUNCTIONARENA_H_ */
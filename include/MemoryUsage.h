@@ -0,0 +1,26 @@
+/*
+ * MemoryUsage.h
+ *
+ * estimated bytes held by parts of the population
+ */
+
+#ifndef INCLUDE_MEMORYUSAGE_H_
+#define INCLUDE_MEMORYUSAGE_H_
+
+#include <vector>
+
+// bytes held by one deme (0D pool is deme 0 at 0,0)
+struct DemeMemoryUsage {
+	int index, x, y;
+	double chromosomes, chiasmata, individuals;
+};
+
+struct MemoryUsage {
+	double chromosomes; // chromosome objects and their junctions
+	double chiasmata; // chiasmata objects and recorded positions
+	double individuals; // individuals themselves (i.e. birthplace and parents)
+	double largest_deme; // sum of all three in the most demanding deme
+	std::vector<DemeMemoryUsage> demes; // the three of every deme
+};
+
+#endif /* INCLUDE_MEMORYUSAGE_H_ */
@@ -0,0 +1,23 @@
+/*
+ * Position.h
+ *
+ * type of positions of junctions and chiasmata along a chromosome,
+ * 16 bits unless built by make WIDE_POSITIONS=1
+ */
+
+#ifndef INCLUDE_POSITION_H_
+#define INCLUDE_POSITION_H_
+
+#include <cstdint>
+#include <limits>
+
+// both types are promoted to int in arithmetic, i.e. positions behave as int
+#ifdef WIDE_POSITIONS
+typedef int32_t Position;
+#else
+typedef uint16_t Position;
+#endif
+
+const long MAX_LOCI = std::numeric_limits<Position>::max(); // the largest LOCI of the build
+
+#endif /* INCLUDE_POSITION_H_ */
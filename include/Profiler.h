@@ -0,0 +1,73 @@
+/*
+ * Profiler.h
+ *
+ * wall and CPU time spent in phases of every generation,
+ * memory held by the population and heap allocations of phases
+ */
+
+#ifndef INCLUDE_PROFILER_H_
+#define INCLUDE_PROFILER_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include <ctime>
+
+#include "../include/Tracer.h"
+#include "../include/MemoryUsage.h"
+
+enum Phase { MIGRATION, BREEDING, STATISTICS, OUTPUT, NUMBER_OF_PHASES };
+
+// wall time (in seconds) spent in phases of the simulation
+struct PhaseTimes {
+	double migration, breeding, statistics, output;
+};
+
+class Profiler {
+	public:
+		Profiler();
+
+		void start(Phase phase);
+		void stop(Phase phase);
+		void countBred(double individuals, double junctions); // bred in current generation
+		void countMemory(const MemoryUsage& usage); // held by population of current generation
+		void endGeneration();
+		void setTracer(Tracer* phase_tracer); // phases are recorded as spans of the timeline too
+
+		PhaseTimes getPhaseTimes() const; // sums over all generations
+		double getLastGenerationTime() const; // wall time of all phases of the last finished generation
+		// format: json or csv, memory of demes of csv goes to a second table (<filename without .csv>_demes.csv)
+		int save(std::string filename, std::string format) const;
+
+	private:
+		struct GenerationRecord {
+			int generation;
+			double wall[NUMBER_OF_PHASES], cpu[NUMBER_OF_PHASES];
+			double individuals, junctions;
+			double allocations[NUMBER_OF_PHASES]; // only in builds counting allocations
+			MemoryUsage memory;
+			long peak_rss_kb;
+		};
+
+		void streamJSON(std::ostream& stream) const;
+		void streamCSV(std::ostream& stream) const;
+		void streamRecordJSON(std::ostream& stream, const GenerationRecord& record) const;
+		void streamRecordCSV(std::ostream& stream, const GenerationRecord& record) const;
+		void streamDemesCSV(std::ostream& stream) const;
+		double perSecondOfBreeding(double count, const GenerationRecord& record) const;
+		long getPeakRSS() const;
+		GenerationRecord sumOfGenerations() const;
+
+		std::vector<GenerationRecord> records;
+		GenerationRecord current;
+
+		// CPU time is the time of the whole process, i.e. summed over all threads
+		std::chrono::steady_clock::time_point wall_start;
+		std::clock_t cpu_start;
+		long allocations_start;
+		Tracer *tracer;
+		double trace_start;
+};
+
+#endif /* INCLUDE_PROFILER_H_ */
@@ -8,6 +8,27 @@
 #ifndef INCLUDE_RANDOM_GENERATOR_H_
 #define INCLUDE_RANDOM_GENERATOR_H_
 
+#include <random>
+#include <vector>
+#include <cstdint>
+
+// cumulative distribution of Poisson with a fixed mean (i.e. LAMBDA), numbers are drawn by its inversion
+class PoissonTable
+{
+	public :
+		explicit PoissonTable(double lambda);
+
+		int sample(double roll) const; // roll is uniform in [0, 1)
+		bool isTabulated() const; // big means are not tabulated
+		double getMean() const;
+
+	private :
+		double mean;
+		std::vector<double> cdf;
+};
+
+class RecombinationMap;
+
 class RandomGenerator
 {
 	public :
@@ -15,8 +36,27 @@ class RandomGenerator
 		
 		int tossAcoin();
 		int recombPosition(int loci);
+		// sorted sample of positions between 1 and loci - 1 (equal positions are kept), returns its size
+		int sampleRecombPositions(int* positions, int count, int loci);
+		int sampleRecombPositions(int* positions, const double* rolls, int count, int loci); // count rolls drawn in advance
+		// sorted sample of positions of a genetic map (equal positions are kept), rolls drawn in advance or nullptr
+		int sampleRecombPositions(int* positions, const double* rolls, int count, const RecombinationMap& map);
 		double uniform();
 		int poisson(double lambda);
+		int poisson(const PoissonTable& table);
+		int binomial(int trials, double probability);
+		int seed(); // seed for an independent generator (i.e. of a deme bred in parallel)
+
+		// batches of draws, words of the engine are drawn at once and transformed in simple loops
+		void fillUniform(double* rolls, int count);
+		void fillCoins(char* coins, int count);
+		void fillPoisson(int* counts, int count, const PoissonTable& table);
+
+	private :
+		const uint32_t* fillWords(int count); // words of the engine in a buffer of the calling thread
+		// sorted positions scaled to the range or placed by the map if given
+		void orderStatistics(int* positions, const double* rolls, int count, int range, const RecombinationMap* map);
+		std::mt19937 engine;
 };
 
 #endif /* INCLUDE_RANDOM_GENERATOR_H_ */
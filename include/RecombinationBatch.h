@@ -0,0 +1,39 @@
+/*
+ * RecombinationBatch.h
+ *
+ * random draws of recombination of all chromosomes passed to gametes by a deme in one generation,
+ * they are drawn at once in simple loops over buffers and consumed chromosome by chromosome,
+ * the batch lives only during breeding, so demes do not hold the buffers between generations
+ */
+
+#ifndef INCLUDE_RECOMBINATIONBATCH_H_
+#define INCLUDE_RECOMBINATIONBATCH_H_
+
+#include <vector>
+
+#include "../include/RandomGenerators.h"
+#include "../include/RecombinationMap.h"
+
+class RecombinationBatch {
+	public:
+		explicit RecombinationBatch(const PoissonTable& chiasmata_table);
+		// chromosomes of gametes follow their genetic maps (one per chromosome, none if recombination is uniform)
+		RecombinationBatch(const PoissonTable& chiasmata_table, const std::vector<RecombinationMap>& recombination_maps);
+
+		void draw(RandomGenerator& random, int chromosomes, int loci); // draws of the given number of chromosomes
+		// draws of the next chromosome: the set the gamete starts by and sorted positions of its chiasmata,
+		// returns the number of chiasmata
+		int next(int& starts_by, const int*& chiasmata);
+		double getLambda() const;
+
+	private:
+		const PoissonTable& chiasmata_table; // numbers of chiasmata of a chromosome
+		const std::vector<RecombinationMap>& recombination_maps;
+		std::vector<int> counts; // number of chiasmata of every chromosome
+		std::vector<char> coins; // set the gamete starts by
+		std::vector<double> rolls; // uniforms the positions are transformed from
+		std::vector<int> positions; // positions of chiasmata of all chromosomes one after another
+		int current, current_position; // the next chromosome and its first chiasma
+};
+
+#endif /* INCLUDE_RECOMBINATIONBATCH_H_ */
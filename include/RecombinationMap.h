@@ -0,0 +1,32 @@
+/*
+ * RecombinationMap.h
+ *
+ * genetic map of a chromosome, relative rates of recombination are constant on intervals of positions
+ * (a chiasma at position p separates loci p - 1 and p), chiasmata are placed by inversion of its
+ * cumulative distribution, the interval of a roll is found by an indexed search in expected constant time
+ */
+
+#ifndef INCLUDE_RECOMBINATIONMAP_H_
+#define INCLUDE_RECOMBINATIONMAP_H_
+
+#include <vector>
+#include <string>
+
+class RecombinationMap {
+	public:
+		// rates[i] is the rate from starts[i] to the next start (the last to the end of chromosome)
+		RecombinationMap(const std::vector<int>& starts, const std::vector<double>& rates, int loci);
+		// maps of all chromosomes from a file of lines "chromosome start rate" (chromosomes are numbered from 1),
+		// chromosomes missing in the file recombine uniformly, empty file name means no maps (uniform recombination)
+		static std::vector<RecombinationMap> load(const std::string& file_name, int chromosomes, int loci);
+
+		int position(double roll) const; // position of a uniform roll in [0, 1), it does not decrease with the roll
+		int getNumberOfPositions() const; // positions with non-zero rate
+
+	private:
+		std::vector<int> starts, ends; // intervals [start, end) of non-zero rate
+		std::vector<double> cdf; // probability of a chiasma before the end of every interval
+		std::vector<int> guide; // guide[j] is the first interval with cdf above j / guide.size()
+};
+
+#endif /* INCLUDE_RECOMBINATIONMAP_H_ */
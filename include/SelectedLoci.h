@@ -0,0 +1,40 @@
+/*
+ * SelectedLoci.h
+ *
+ * loci under selection of a chromosome, evenly spaced or listed by the setting, kept as a bit-vector over loci
+ * with ranks of its words, so selected loci of a junction interval are counted by two rank queries,
+ * genotype of up to 64 selected loci of a chromosome is packed by bits (1 is B) in a word
+ */
+
+#ifndef INCLUDE_SELECTEDLOCI_H_
+#define INCLUDE_SELECTEDLOCI_H_
+
+#include <vector>
+#include <cstdint>
+
+class SelectedLoci {
+	public:
+		static const int PACKED_LOCI = 64; // selected loci of a packed genotype
+
+		SelectedLoci(int loci, int selected_loci); // the first and the last locus and loci evenly spaced between them
+		SelectedLoci(int loci, const std::vector<int>& positions); // sorted distinct loci
+
+		// layouts of chromosomes, a single list of positions is shared by all chromosomes
+		static std::vector<SelectedLoci> layout(int chromosomes, int loci, int selected_loci,
+				const std::vector<std::vector<int> >& positions);
+
+		int size() const; // selected loci of a chromosome
+		bool isPackable() const; // genotype of selected loci fits a word
+		int rank(int position) const; // selected loci before the position
+
+		static uint64_t bits(int from, int to); // word with bits [from, to) set
+
+	private:
+		void build(const std::vector<int>& positions);
+
+		std::vector<uint64_t> words; // bit of every locus (1 is selected), a spare word ends the vector
+		std::vector<int> ranks; // selected loci before every word
+		int selected;
+};
+
+#endif /* INCLUDE_SELECTEDLOCI_H_ */
@@ -34,6 +34,7 @@ class SettingHandler{
 	private:
 		int parseSetting(std::ifstream& myfile);
 		int parseWorldDefinition(std::string& line);
+		void parseSelectedPositions(const std::string& value);
 		void parameterSave(std::string& parameter, double value);
 		void parameterSave(std::string& parameter, std::vector<double>& value);
 		void updateNumberOfSimulations();
@@ -44,11 +45,13 @@ class SettingHandler{
 
 		// simulation parameters
 
-		std::vector<int> loci, selected_loci, chrom, deme, gen;
+		std::vector<int> loci, selected_loci, chrom, deme, gen, threads;
 		std::vector<double> sel, beta, lambda;
 
 		// capture output parameters
-		std::string file_name_patten, type_of_save;
+		std::string file_name_patten, type_of_save, type_of_profile, type_of_trace, type_of_pool;
+		std::string recombination_map; // file of genetic maps, empty if recombination is uniform
+		std::vector<std::vector<int> > selected_positions; // listed selected loci of chromosomes, empty if evenly spaced
 		std::vector<int> seed, delay, saves;
 
 		// world setting
@@ -9,21 +9,29 @@
 #define INCLUDE_SIMULATION_H_
 
 #include <string>
+#include <memory>
 
 #include "../include/World.h"
 #include "../include/SimulationSetting.h"
+#include "../include/Profiler.h"
+#include "../include/Tracer.h"
 
 class Simulation {
 	public:
 		Simulation(SimulationSetting& simulation_setting);
 		int simulate();
+		PhaseTimes getPhaseTimes() const;
 
 	private:
 		void setWorld(SimulationSetting& simulation_setting);
 		int saveWorld(int order, int save_pos);
 
 		std::string file_name, file_type;
+		std::string profile_name, profile_type; // profile is saved at the end of simulation (json or csv)
+		std::string trace_name; // timeline is saved at the end of simulation if traced
 		int generations, delay, saves;
+		Profiler profiler;
+		std::unique_ptr<Tracer> tracer; // empty if simulation is not traced
 		World world;
 };
 
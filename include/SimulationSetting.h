@@ -9,13 +9,16 @@
 #define INCLUDE_SIMSET_H_
 
 #include <string>
+#include <vector>
 
 struct SimulationSetting{
-	int loci, selected_loci, chromosomes, deme_size, generations;
+	int loci, selected_loci, chromosomes, deme_size, generations, threads;
 	double lambda, selection, beta;
 
 	int saves, delay, seed;
-	std::string file_to_save, type_of_save;
+	std::string file_to_save, type_of_save, type_of_profile, type_of_trace, type_of_pool;
+	std::string recombination_map; // file of genetic maps of chromosomes, empty if recombination is uniform
+	std::vector<std::vector<int> > selected_positions; // selected loci of every chromosome (or of all), empty if evenly spaced
 
 	int up_down_demes, left_right_demes, dimension, edges_per_deme;
 	std::string type_of_updown_edges, type_of_leftright_edges;
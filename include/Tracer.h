@@ -0,0 +1,46 @@
+/*
+ * Tracer.h
+ *
+ * timeline of spans (breeding of demes, migration, summary, saving) saved in
+ * Chrome Trace Event format (readable by chrome://tracing or Perfetto)
+ */
+
+#ifndef INCLUDE_TRACER_H_
+#define INCLUDE_TRACER_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+
+struct TraceEvent {
+	const char *name, *category;
+	double begin, duration; // microseconds from the start of tracing
+	int deme, x, y; // deme is -1 for spans not belonging to a deme
+};
+
+class Tracer {
+	public:
+		Tracer(int threads);
+
+		double now() const;
+		// span from begin to now recorded by the calling thread
+		void record(const char* name, const char* category, double begin, int deme = -1, int x = 0, int y = 0);
+		int save(std::string filename) const;
+
+	private:
+		// every thread writes only to its own buffer, therefore no locking is needed,
+		// padding keeps buffers of different threads in different cache lines
+		struct ThreadBuffer {
+			std::vector<TraceEvent> events;
+			char padding[64];
+		};
+
+		int threadId() const;
+		void streamEvent(std::ostream& stream, const TraceEvent& event, int thread) const;
+
+		std::chrono::steady_clock::time_point origin;
+		std::vector<ThreadBuffer> buffers;
+};
+
+#endif /* INCLUDE_TRACER_H_ */
@@ -0,0 +1,30 @@
+/*
+ * TractHistogram.h
+ *
+ * counts of ancestry tracts (blocks of A or B) of a deme or of the 0D pool by their length in loci,
+ * bins are logarithmic, the bin k counts tracts of [2^k, 2^(k+1)) loci
+ */
+
+#ifndef INCLUDE_TRACTHISTOGRAM_H_
+#define INCLUDE_TRACTHISTOGRAM_H_
+
+#include <vector>
+
+class TractHistogram {
+	public:
+		// bins up to the one of a tract of the whole chromosome, unless loci is a power of two the last bin
+		// also holds shorter tracts (i.e. [512, 1024) of 1000 loci)
+		explicit TractHistogram(int loci);
+
+		void add(const std::vector<int>& sizes, int copies = 1); // every tract is counted copies times
+		void clear();
+
+		int getNumberOfBins() const;
+		long long getCount(int bin) const;
+		static int binOf(int length);
+
+	private:
+		std::vector<long long> counts;
+};
+
+#endif /* INCLUDE_TRACTHISTOGRAM_H_ */
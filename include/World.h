@@ -15,8 +15,12 @@
 #include "../include/Chromosome.h"
 #include "../include/Individual.h"
 #include "../include/Imigrant.h"
+#include "../include/ImigrantPool.h"
 #include "../include/Deme.h"
 #include "../include/SimulationSetting.h"
+#include "../include/Tracer.h"
+#include "../include/SelectionModel.h"
+#include "../include/RecombinationMap.h"
 
 class World {
 	public:
@@ -44,7 +48,12 @@ class World {
 		void showOneDeme(int index);
 		int saveTheUniverse(std::string type, std::string filename);
 		void getLD();
+		double getMeanNumberOfJunctions();
+		int getNumberOfIndividuals() const;
+		double getMaterial() const; // sum of proportions of B of 0D pool
+		MemoryUsage getMemoryUsage() const;
 
+		void setTracer(Tracer* world_tracer); // spans of breeding and migration are recorded to tracer
 		void restart(); // clear the space, creates a new one (2 columns, rows defined by user)
 		void clear();   // deletes all demes
 
@@ -54,7 +63,7 @@ class World {
 		int upperBorder(int index, int max_index); // function returns index of upper neigbour for new demes
 		int lowerBorder(int index, int max_index);
 		int sideBorder(int reflexive, int extending);
-		bool isGameteA(std::vector<Chromosome>& gamete);
+		Individual createEdgeIndividual(char origin, int x, int y, int index) const;
 
 	// saving methods
 		int saveLinesPerIndividual(std::ofstream& ofile, std::string type);
@@ -62,11 +71,16 @@ class World {
 		int saveRaspberrypi(std::ostream& ofile);
 		int saveBlocks(std::ofstream& ofile);
 		int saveBacktrace(std::ofstream& ofile);
+		int saveLinkage(std::ofstream& ofile);
+		int saveTracts(std::ofstream& ofile);
+		int saveJunctionDensity(std::ofstream& ofile);
 
 		void streamBlockSizesOf0DWorld(std::ostream& stream);
+		void streamTractsOf0DWorld(std::ostream& stream);
+		void streamJunctionDensityOf0DWorld(std::ostream& stream);
+		void countImigrant(ImigrantPool& pool, int index, PoolStatistics& statistics, SelectionModel& selection_model) const;
 
 	// stats
-		double getMaterial() const;
 		int getTotalNumberOfBBlocks();
 		double getMeanFitness() const;
 
@@ -80,15 +94,23 @@ class World {
 	//	parameters:	deme, individual, chromosome setting
 		const int deme_size, number_of_chromosomes, number_of_loci, number_of_selected_loci;
 		const double selection, beta, lambda;
+		const std::vector<SelectedLoci> selected_loci; // loci under selection of every chromosome
+		const std::vector<RecombinationMap> recombination_maps; // genetic maps of chromosomes, empty if recombination is uniform
 
 	//	internal
+		const int threads; // number of threads breeding demes in parallel
+		const bool weighted_pool; // identical imigrants of 0D pool are stored once with number of copies
+		const bool record_pedigree; // individuals keep their birthplace and parents (backtrace is saved)
+		Tracer *tracer; // nullptr if the simulation is not traced
 		const int edges_per_deme; // defines migration and extension of hybrid zone
 		int index_last_left, index_next_left; // variables handling dynamic extension of hybrid zone
 		int index_last_right, index_next_right;
 
 	//	containers
 		std::map<int, Deme*> world; // container of Demes for non zero dimensional simation
-		std::vector<Imigrant> zeroD_immigrant_pool; // container of individuals for 0 dimensional simualtion
+		ImigrantPool zeroD_pool; // container of individuals for 0 dimensional simualtion
+		std::vector<ImigrantPool> zeroD_offspring; // the second generation buffer, one part per chunk of parents
+		PoolStatistics zeroD_statistics; // of the current pool, updated by migration and breeding
 };
 
 #endif /* INCLUDE_WORLD_H_ */
@@ -0,0 +1 @@
+#define GITVERSION "a2623651325a1d87d0e6939b1dc499d0b6336f9c"
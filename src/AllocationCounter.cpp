@@ -0,0 +1,63 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * opt-in counting of heap allocations
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../include/AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// demes are bred in parallel, relaxed atomic increment is enough for counting
+static std::atomic<long> allocations(0);
+
+void* operator new(std::size_t size){
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void *pointer = std::malloc(size == 0 ? 1 : size);
+	if(pointer == nullptr){
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+bool AllocationCounter::enabled(){
+	return true;
+}
+
+long AllocationCounter::count(){
+	return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::enabled(){
+	return false;
+}
+
+long AllocationCounter::count(){
+	return 0;
+}
+
+#endif
@@ -20,39 +20,70 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <utility>
 
 #include "../include/Chiasmata.h"
 
 /* INITIATION */
 
-Chiasmata::Chiasmata(){ }
+Chiasmata::Chiasmata() : number_of_chiasmata{0}, capacity{INLINE_CHIASMATA} { }
 
-Chiasmata::Chiasmata(std::vector<int> input_chiasmata){
-	chiasmata = input_chiasmata;
+Chiasmata::Chiasmata(const std::vector<int>& input_chiasmata) : Chiasmata() {
+	set(input_chiasmata);
+}
+
+Chiasmata::Chiasmata(const int* first, const int* last) : Chiasmata() {
+	reserve(last - first);
+	std::copy(first, last, positions());
+	number_of_chiasmata = last - first;
+}
+
+Chiasmata::Chiasmata(const Chiasmata& other) : Chiasmata() {
+	*this = other;
+}
+
+Chiasmata& Chiasmata::operator=(const Chiasmata& other){
+	if(this != &other){
+		reserve(other.number_of_chiasmata);
+		std::copy(other.positions(), other.positions() + other.number_of_chiasmata, positions());
+		number_of_chiasmata = other.number_of_chiasmata;
+	}
+	return *this;
 }
 
 Chiasmata::~Chiasmata(){
-	chiasmata.clear();
 }
 
 int Chiasmata::length() const{
-	return chiasmata.size();
+	return number_of_chiasmata;
 }
 
 int Chiasmata::get(int index) const{
-	if( index > length()){
+	if( index >= length()){
 		throw std::runtime_error("Problematic request on chiasmata.get(index), index bigger than number of chiasmata");
 	}
-	return chiasmata[index];
+	return positions()[index];
 }
 
-void Chiasmata::set(std::vector<int> input_chiasmata){
-	chiasmata = input_chiasmata;
+void Chiasmata::set(const std::vector<int>& input_chiasmata){
+	reserve(input_chiasmata.size());
+	std::copy(input_chiasmata.begin(), input_chiasmata.end(), positions());
+	number_of_chiasmata = input_chiasmata.size();
 }
 
+// chiasmata are kept sorted by insertion, no sorting of the whole array
 void Chiasmata::add(int chiasma){
-	chiasmata.push_back(chiasma);
-	sort(chiasmata.begin(), chiasmata.end());
+	reserve(number_of_chiasmata + 1);
+	Position *last = positions() + number_of_chiasmata;
+	Position *pos = std::upper_bound(positions(), last, chiasma);
+	std::copy_backward(pos, last, last + 1);
+	*pos = chiasma;
+	number_of_chiasmata++;
+}
+
+double Chiasmata::getMemoryUsage() const{
+	return sizeof(Chiasmata) + (spilled ? capacity * sizeof(Position) : 0);
 }
 
 std::string Chiasmata::collapse() const{
@@ -62,10 +93,32 @@ std::string Chiasmata::collapse() const{
 	std::string collapsed;
 	for(int chiasma = 0; chiasma < length(); chiasma++){
 		if(collapsed == ""){
-			collapsed = std::to_string(chiasmata[chiasma]);
+			collapsed = std::to_string(positions()[chiasma]);
 		} else {
-			collapsed = collapsed + "," + std::to_string(chiasmata[chiasma]);
+			collapsed = collapsed + "," + std::to_string(positions()[chiasma]);
 		}
 	}
 	return collapsed;
-}
\ No newline at end of file
+}
+
+/* PROTECTED */
+
+Position* Chiasmata::positions(){
+	return spilled ? spilled.get() : inline_chiasmata;
+}
+
+const Position* Chiasmata::positions() const{
+	return spilled ? spilled.get() : inline_chiasmata;
+}
+
+// recorded chiasmata are kept, the array grows twice to amortize adding
+void Chiasmata::reserve(int new_capacity){
+	if(new_capacity <= capacity){
+		return;
+	}
+	new_capacity = std::max(new_capacity, 2 * capacity);
+	std::unique_ptr<Position[]> grown(new Position[new_capacity]);
+	std::copy(positions(), positions() + number_of_chiasmata, grown.get());
+	spilled = std::move(grown);
+	capacity = new_capacity;
+}
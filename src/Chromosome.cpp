@@ -18,23 +18,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 #include "../include/Chromosome.h"
 #include "../include/RandomGenerators.h"
 
-typedef std::map<int, char>::const_iterator const_iterator;
+typedef Junctions::const_iterator const_iterator;
+
+// junctions are searched by position only
+bool isBefore(const Junction& junction, int position){
+	return junction.first < position;
+}
+
+bool isAfter(int position, const Junction& junction){
+	return position < junction.first;
+}
 /* INITIATION */
 
-Chromosome::Chromosome(){
+Chromosome::Chromosome() : selected_genotype{0}, packed{false} {
 	loci = 0;
 }
 
-Chromosome::Chromosome(char starting_char, int size){
-	chromosome[0] = starting_char;
+Chromosome::Chromosome(char starting_char, int size) : selected_genotype{0}, packed{false} {
+	chromosome.push_back(Junction(0, starting_char));
 	loci = size;
 }
 
-Chromosome::Chromosome(std::map <int, char> input_chrom, int size){
+Chromosome::Chromosome(const Junctions& input_chrom, int size) : selected_genotype{0}, packed{false} {
 	chromosome = input_chrom;
 	loci = size;
 }
@@ -86,10 +96,67 @@ int Chromosome::countB() const{
 	return sum;
 }
 
+// every B block sets the bits of selected loci it covers
+void Chromosome::packSelected(const SelectedLoci& selected){
+	if(!selected.isPackable()){
+		return;
+	}
+	selected_genotype = 0;
+	for(const_iterator pos = chromosome.begin(); pos != chromosome.end(); ++pos){
+		if(pos->second == 'B'){
+			int end = (pos + 1 != chromosome.end()) ? (pos + 1)->first : loci;
+			selected_genotype |= SelectedLoci::bits(selected.rank(pos->first), selected.rank(end));
+		}
+	}
+	packed = true;
+}
+
+bool Chromosome::isPacked() const{
+	return packed;
+}
+
+// B blocks of unpacked chromosomes count selected loci they cover
+int Chromosome::countSelectedB(const SelectedLoci& selected) const{
+	if(packed){
+		return __builtin_popcountll(selected_genotype);
+	}
+	int count = 0;
+	for(const_iterator pos = chromosome.begin(); pos != chromosome.end(); ++pos){
+		if(pos->second == 'B'){
+			int end = (pos + 1 != chromosome.end()) ? (pos + 1)->first : loci;
+			count += selected.rank(end) - selected.rank(pos->first);
+		}
+	}
+	return count;
+}
+
 int Chromosome::getNumberOfJunctions() const{
 	return chromosome.size() - 1;
 }
 
+double Chromosome::getMemoryUsage() const{
+	return sizeof(Chromosome) + chromosome.capacity() * sizeof(Junction);
+}
+
+// a B block adds the weight from its first locus on and removes it after its last locus
+void Chromosome::addBBlocks(int* difference, int weight) const{
+	for(const_iterator pos = chromosome.begin(); pos != chromosome.end(); ++pos){
+		if(pos->second == 'B'){
+			difference[pos->first] += weight;
+			difference[(pos + 1 == chromosome.end()) ? loci : (pos + 1)->first] -= weight;
+		}
+	}
+}
+
+// bins split the chromosome evenly, the first junction (at 0) is the material the chromosome starts by
+void Chromosome::addJunctionPositions(long long* counts, int bins, int weight) const{
+	for(const_iterator pos = chromosome.begin(); pos != chromosome.end(); ++pos){
+		if(pos->first > 0){
+			counts[(long long)pos->first * bins / loci] += weight;
+		}
+	}
+}
+
 void Chromosome::getSizesOfBBlocks(std::vector<int>& sizes){
 	char last_seq = 'A';
 	int last_val = 0;
@@ -134,71 +201,146 @@ void Chromosome::getSizesOfBlocks(std::vector<int>& sizes) const{
 }
 
 void Chromosome::makeRecombinant(Chromosome& chromNew, int numberOfChaisma, const Context &context){
+	makeRecombinant(chromNew, numberOfChaisma, context.random);
+}
+
+bool Chromosome::makeRecombinant(Chromosome& chromNew, int numberOfChaisma, RandomGenerator& random){
 // 	starts_by 0 home, 1 alien
-	int starts_by = context.random.tossAcoin();
+	int starts_by = random.tossAcoin();
 	std::vector<int> recombination;
+	drawRecombination(recombination, numberOfChaisma, random);
+	writeRecombinant(chromNew, recombination, starts_by);
+	return numberOfChaisma == 0 and starts_by == 1;
+}
+
+void Chromosome::drawRecombination(std::vector<int>& recombination, int numberOfChaisma, RandomGenerator& random) const{
+	recombination.resize(numberOfChaisma);
+	recombination.resize(random.sampleRecombPositions(recombination.data(), numberOfChaisma, loci));
+}
+
+void Chromosome::drawRecombination(std::vector<int>& recombination, int numberOfChaisma, RandomGenerator& random, const RecombinationMap* map) const{
+	if(map == nullptr){
+		drawRecombination(recombination, numberOfChaisma, random);
+		return;
+	}
+	recombination.resize(numberOfChaisma);
+	recombination.resize(random.sampleRecombPositions(recombination.data(), nullptr, numberOfChaisma, *map));
+}
+
+// the locus x is inherited if starts_by == 1 and number of chiasmata <= x is even (or vice versa)
+bool Chromosome::inheritsB(const std::vector<int>& recombination, int starts_by) const{
+	bool inherited = starts_by == 1;
+	char material = 'A';
+	unsigned int index = 0;
+	const_iterator pos = chromosome.begin();
+	while(pos != chromosome.end() or index < recombination.size()){
+		int position = (pos != chromosome.end()) ? pos->first : recombination[index];
+		if(index < recombination.size() and recombination[index] < position){
+			position = recombination[index];
+		}
+		while(index < recombination.size() and recombination[index] == position){
+			inherited = !inherited;
+			index++;
+		}
+		if(pos != chromosome.end() and pos->first == position){
+			material = pos->second;
+			++pos;
+		}
+		if(inherited and material == 'B'){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// recombinant of the home chromosome (pure A) and of this (alien) chromosome
+void Chromosome::writeRecombinant(Chromosome& chromNew, const std::vector<int>& recombination, int starts_by) const{
 	chromNew.clear();
 	chromNew.setResolution(loci);
-	chromNew.write(0,'A');
 
 // 	this condition can be deleted if I will handle the numberOfChaisma=0 on some upper level
-	if(numberOfChaisma == 0){
+	if(recombination.empty()){
 		if(starts_by == 0){
+			chromNew.write(0,'A');
 			return;
 		}
-		chromNew = Chromosome(chromosome, loci);
+		chromNew.chromosome = chromosome; // junctions stay in the arena of chromNew
 		return;
 	}
 
-	int index, lastposition = 0;
-
-	for(index=0;index<numberOfChaisma;index++){
-		recombination.push_back(context.random.recombPosition(loci));
-	}
-
-	sort(recombination.begin(), recombination.end());
+	const Junction home(0, 'A');
+	const Junction *first[2] = {&home, chromosome.data()};
+	const Junction *last[2] = {&home + 1, chromosome.data() + chromosome.size()};
+	chromNew.chromosome.reserve(chromosome.size() + recombination.size());
+	mergeRecombinant(chromNew.chromosome, first, last, recombination.data(), recombination.size(), starts_by);
+}
 
-	/*for(index=0;index<numberOfChaisma;index++){
-		cout << recombination[index] << ' ';
+void Chromosome::writeRecombinant(Chromosome& chromNew, const Chromosome& parent1, const Chromosome& parent2,
+		const int* recombination, int numberOfChaisma, int starts_by, const SelectedLoci* selected){
+	chromNew.clear();
+	chromNew.setResolution(parent1.loci);
+	const Junction *first[2] = {parent1.chromosome.data(), parent2.chromosome.data()};
+	const Junction *last[2] = {first[0] + parent1.chromosome.size(), first[1] + parent2.chromosome.size()};
+	chromNew.chromosome.reserve(std::max(parent1.chromosome.size(), parent2.chromosome.size()) + numberOfChaisma);
+	mergeRecombinant(chromNew.chromosome, first, last, recombination, numberOfChaisma, starts_by);
+
+	// selected loci between ranks of the chiasma 2k and 2k + 1 come from the other parent
+	if(selected != nullptr and parent1.packed and parent2.packed){
+		const uint64_t parents[2] = {parent1.selected_genotype, parent2.selected_genotype};
+		uint64_t other = 0;
+		for(int i = 0; i < numberOfChaisma; i += 2){
+			int to = (i + 1 < numberOfChaisma) ? selected->rank(recombination[i + 1]) : selected->size();
+			other |= SelectedLoci::bits(selected->rank(recombination[i]), to);
+		}
+		chromNew.selected_genotype = (parents[starts_by] & ~other) | (parents[1 - starts_by] & other);
+		chromNew.packed = true;
 	}
-	cout << endl;*/
+}
 
-	index = 0;
-	for(const_iterator pos=chromosome.begin(); pos!=chromosome.end(); ++pos){
-		while(recombination[index] <= pos->first && index < numberOfChaisma){
-			if (chromosome[lastposition] != 'A'){
-				if (starts_by == 1){
-					chromNew.write(recombination[index],'A');
-				} else {
-					chromNew.write(recombination[index],'B');
-				}
+// one pass over junctions of both parents, the recombinant has the material of the parent starts_by
+// up to the first chiasma and the parents alternate at every chiasma (chiasmata on the same position
+// cancel out), junctions that do not change the material are not written
+void Chromosome::mergeRecombinant(Junctions& recombinant, const Junction* const first[2], const Junction* const last[2],
+		const int* recombination, int numberOfChaisma, int starts_by){
+	const Junction *pos[2] = {first[0], first[1]};
+	char material[2] = {0, 0}; // material of the parents before their next junction
+	char written = 0; // material of the last written junction
+	int source = starts_by;
+	int index = 0;
+	while(true){
+		int chiasma = (index < numberOfChaisma) ? recombination[index] : std::numeric_limits<int>::max();
+		for(; pos[source] != last[source] and pos[source]->first < chiasma; ++pos[source]){
+			material[source] = pos[source]->second;
+			if(material[source] != written){
+				recombinant.push_back(*pos[source]);
+				written = material[source];
 			}
-			starts_by = abs(starts_by - 1);
-			index++;
 		}
-		if(starts_by == 1){
-			chromNew.write(pos->first,pos->second);
+		if(index == numberOfChaisma){
+			return;
 		}
-		lastposition = pos->first;
-	}
-
-	while(index < numberOfChaisma){
-		if (chromosome[lastposition] != 'A'){
-			if (starts_by == 1){
-				chromNew.write(recombination[index],'A');
-			} else {
-				chromNew.write(recombination[index],'B');
-			}
+		bool crossover = true;
+		for(index++; index < numberOfChaisma and recombination[index] == chiasma; index++){
+			crossover = !crossover;
+		}
+		if(!crossover){
+			continue;
+		}
+		source = 1 - source;
+		for(; pos[source] != last[source] and pos[source]->first <= chiasma; ++pos[source]){
+			material[source] = pos[source]->second;
+		}
+		if(material[source] != written){
+			recombinant.push_back(Junction(chiasma, material[source]));
+			written = material[source];
 		}
-		starts_by = abs(starts_by - 1);
-		index++;
 	}
-	return;
 }
 
 /* COMUNICATION METHODS */
 void Chromosome::setResolution(int res){
 	loci = res;
+	packed = false;
 }
 
 int Chromosome::getResolution() const{
@@ -207,25 +349,40 @@ int Chromosome::getResolution() const{
 
 void Chromosome::clear(){
 	chromosome.clear();
+	packed = false;
 	loci = 0;
 } /* method for deleting chromosome */
 
+// junctions are sorted by position, the last junction not after i holds the material of locus i
 char Chromosome::read(int i){
-	return chromosome[i];
-} /* returns value of junction */
+	Junctions::iterator pos = std::upper_bound(chromosome.begin(), chromosome.end(), i, isAfter);
+	return pos == chromosome.begin() ? 0 : (pos - 1)->second;
+} /* returns value of locus */
 
+// junctions are mostly written in increasing order of positions, i.e. appended
 void Chromosome::write(int i, char l){
-	chromosome[i] = l;
+	packed = false;
+	if(chromosome.empty() or chromosome.back().first < i){
+		chromosome.push_back(Junction(i, l));
+		return;
+	}
+	Junctions::iterator pos = std::lower_bound(chromosome.begin(), chromosome.end(), i, isBefore);
+	if(pos != chromosome.end() and pos->first == i){
+		pos->second = l;
+	} else {
+		chromosome.insert(pos, Junction(i, l));
+	}
 }
 
-std::map<int, char>::iterator Chromosome::begin(){
+Junctions::iterator Chromosome::begin(){
 	return chromosome.begin();
 }
 
-std::map<int, char>::iterator Chromosome::end(){
+Junctions::iterator Chromosome::end(){
 	return chromosome.end();
 }
 
-std::map<int, char>::iterator Chromosome::find(int i){
-	return chromosome.find(i);
+Junctions::iterator Chromosome::find(int i){
+	Junctions::iterator pos = std::lower_bound(chromosome.begin(), chromosome.end(), i, isBefore);
+	return (pos != chromosome.end() and pos->first == i) ? pos : chromosome.end();
 }
@@ -21,6 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <cmath>
 #include <iomanip>
 #include <fstream>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
 
 #include "../include/RandomGenerators.h"
 #include "../include/Chiasmata.h"
@@ -34,8 +37,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // constructor/destructors functions / //
 // // // // // // // // // // // // // //
 
-Deme::Deme(const Context& context, int ind, std::vector<int> neigb, char init, int size, double sel, double beta, int in_ch, int in_loc, int in_sel_loci, double in_lambda, int in_x, int in_y)
-	: context{context}
+// the seed of deme's generator is drawn from the generator of the world
+Deme::Deme(const Context& world_context, int ind, std::vector<int> neigb, char init, int size, double sel, double beta, int in_ch, int in_loc, const std::vector<SelectedLoci>& in_selected, double in_lambda, const std::vector<RecombinationMap>& in_maps, bool in_pedigree, int in_x, int in_y)
+	: context{world_context.random.seed()}, current_arena{0},
+	  selected_loci(in_selected), lambda{in_lambda}, record_pedigree{in_pedigree}, chiasmata_table{in_lambda}, recombination_maps(in_maps),
+	  b_profile(in_ch * (in_loc + 1), 0), number_of_loci{in_loc}
 {
 	x = in_x;
 	y = in_y;
@@ -45,21 +51,44 @@ Deme::Deme(const Context& context, int ind, std::vector<int> neigb, char init, i
 	deme = new Individual[deme_size];
 	if(init == 'A' or init == 'B'){
 		for(int i=0;i<deme_size;i++){
-			deme[i] = Individual(&context, init, in_ch, in_loc, in_lambda, in_sel_loci, std::tuple<int, int, int>(in_x, in_y, i));
+			deme[i] = Individual(init, in_ch, in_loc);
 		}
 	} else {
 		int i = 0;
 		while(i< (deme_size / 2)){
-			deme[i] = Individual(&context, 'A', in_ch, in_loc, in_lambda, in_sel_loci, std::tuple<int, int, int>(in_x, in_y, i));
+			deme[i] = Individual('A', in_ch, in_loc);
 			i++;
 		}
 		while(i< deme_size){
-			deme[i] = Individual(&context, 'B', in_ch, in_loc, in_lambda, in_sel_loci, std::tuple<int, int, int>(in_x, in_y, i));
+			deme[i] = Individual('B', in_ch, in_loc);
 			i++;
 		}
 	}
+	rebuildBProfile();
+	if(record_pedigree){
+		for(int i=0;i<deme_size;i++){
+			deme[i].setPedigree(std::tuple<int, int, int>(in_x, in_y, i), std::tuple<int, int, int>(), std::tuple<int, int, int>());
+		}
+	}
 	selection_model.setSelectionPressure(sel);
 	selection_model.setBeta(beta);
+	// the mode of the world does not change, the matching kernels are picked once
+	if(record_pedigree){
+		offspring_kernel = (lambda > 0) ? &Deme::breedOffspring<true, true> : &Deme::breedOffspring<true, false>;
+	} else {
+		offspring_kernel = (lambda > 0) ? &Deme::breedOffspring<false, true> : &Deme::breedOffspring<false, false>;
+	}
+	bool all_selected = true;
+	for(unsigned int i = 0; i < selected_loci.size(); i++){
+		all_selected = all_selected and selected_loci[i].size() == in_loc;
+	}
+	if(all_selected){
+		fitness_kernel = &Deme::fillFitnessVector<true>;
+		packed_loci = nullptr;
+	} else {
+		fitness_kernel = &Deme::fillFitnessVector<false>;
+		packed_loci = &selected_loci;
+	}
 }
 
 
@@ -103,12 +132,11 @@ int Deme::getY(){
 // // // // computing functions / // // /
 // // // // // // // // // // // // // //
 
+// junctions of offspring are allocated in the second arena, the arena of parents (and of migrants
+// integrated to parents) is released at once when the offspring replace them
 void Deme::Breed(){
-	double lambda = deme[0].getLambda();
-	int sel_loci = deme[0].getNumberOfSelectedLoci();
+	JunctionArena::Scope arena_scope(&arenas[1 - current_arena]);
 	std::vector<double> fitnessVector;
-	std::vector<Chromosome> gamete1, gamete2;
-	std::vector<Chiasmata> chiasmata1, chiasmata2;
 	getFitnessVector(fitnessVector);
 
 	// for(unsigned int i = 0; i < fitnessVector.size(); i++){
@@ -123,8 +151,10 @@ void Deme::Breed(){
 	std::vector<int> mothers(deme_size);
 	std::vector<int> fathers(deme_size);
 
+	std::vector<double> rolls(deme_size * 2);
+	context.random.fillUniform(rolls.data(), deme_size * 2);
 	for(int i=0;i < deme_size*2;i++){
-		roll = (context.random.uniform() * RandMax);
+		roll = (rolls[i] * RandMax);
 		it = parentPick.find(roll);
 		while(it != parentPick.end()){ //rolling twice same number will overwrite the first one, but this event is so rare, that solution is to just roll again without any bias
 			roll = (context.random.uniform() * RandMax);
@@ -151,25 +181,21 @@ void Deme::Breed(){
 	}
 
 	Individual *metademe = new Individual[deme_size];
-	for(int i=0;i<deme_size;i++){
-		deme[mothers[i]].makeGamete(gamete1, chiasmata1);
-		deme[fathers[i]].makeGamete(gamete2, chiasmata2);
-		std::tuple<int, int, int> ind_birthplace(x,y,i);
-		metademe[i] = Individual(&context, gamete1, chiasmata1, gamete2, chiasmata2, lambda, sel_loci, ind_birthplace);
-		metademe[i].setParents(deme[mothers[i]].getBirthplace(),
-							   deme[fathers[i]].getBirthplace());
-	}
+	(this->*offspring_kernel)(metademe, mothers, fathers);
 
-	for(int i=0;i<deme_size;i++){
-		deme[i] = metademe[i];
-	}
+	std::swap(deme, metademe);
 	delete[] metademe;
+	arenas[current_arena].reset();
+	current_arena = 1 - current_arena;
+	rebuildBProfile();
 }
 
 void Deme::integrateMigrantVector(std::vector<Individual>& migBuffer){
 	unsigned int i = 0;
 	while(i < migBuffer.size()){
+		deme[i].addBBlocks(b_profile, -1);
 		deme[i] = migBuffer[i];
+		deme[i].addBBlocks(b_profile, 1);
 		i++;
 	}
 	return;
@@ -184,6 +210,29 @@ double Deme::getMeanBproportion() const{
 	return (props / deme_size);
 }
 
+double Deme::getMeanNumberOfJunctions(){
+	double junctions = 0;
+	for(int i = 0;i < deme_size;i++){
+		junctions += deme[i].getNumberOfJunctions();
+	}
+	return (junctions / deme_size);
+}
+
+void Deme::addMemoryUsage(MemoryUsage& usage) const{
+	MemoryUsage deme_usage{0, 0, 0, 0};
+	for(int i = 0;i < deme_size;i++){
+		deme[i].addMemoryUsage(deme_usage);
+	}
+	usage.chromosomes += deme_usage.chromosomes;
+	usage.chiasmata += deme_usage.chiasmata;
+	usage.individuals += deme_usage.individuals;
+	usage.demes.push_back(DemeMemoryUsage{index, x, y, deme_usage.chromosomes, deme_usage.chiasmata, deme_usage.individuals});
+	double deme_total = deme_usage.chromosomes + deme_usage.chiasmata + deme_usage.individuals;
+	if(deme_total > usage.largest_deme){
+		usage.largest_deme = deme_total;
+	}
+}
+
 double Deme::getProportionOfHomozygotes(char population) const{
 	double proportion = 0;
 	if(population == 'A'){
@@ -216,27 +265,7 @@ double Deme::getProportionOfHeterozygotes() const{
 
 
 void Deme::getFitnessVector(std::vector<double> &fitnessVector){
-	double sum = 0, read_fitness = 0;
-	fitnessVector.reserve(deme_size);
-	if(deme[0].getNumberOfLoci(0) == deme[0].getNumberOfSelectedLoci()){
-		for(int i = 0;i < deme_size;i++){
-			// getBprop > getHetProp ??
-			read_fitness = selection_model.getFitness(deme[i].getBprop());
-	//		std::cout << " B prop: " << deme[i].getBprop() << " - fitness: " << read_fitness << std::endl;
-			sum += read_fitness;
-			fitnessVector.push_back(sum);
-		}
-	} else {
-		for(int i = 0;i < deme_size;i++){
-			// getBprop > getHetProp ??
-			read_fitness = selection_model.getFitness(deme[i].getSelectedHybridIndex());
-	//		std::cout << " B prop: " << deme[i].getBprop() << " - fitness: " << read_fitness << std::endl;
-			sum += read_fitness;
-			fitnessVector.push_back(sum);
-		}
-	}
-
-	return;
+	(this->*fitness_kernel)(fitnessVector);
 }
 
 // Computes average fitness in the deme
@@ -277,54 +306,22 @@ double Deme::getVARp(){
 	return varp;
 }
 
-void Deme::getps(std::vector<double>& ps, int ch){
-	double p = 0;
-	int TotalCHnum = deme_size * 2; //total number of chromosomes in deme (which one is computed using parameter ch)
-	int number_loci = deme[0].getNumberOfLoci(0);
-	std::vector<bool> states;	// 0 'A', 1 'B'
-	std::vector<std::map<int, char>::iterator> chroms; //vector with chromosome junctions
-	std::vector<int> ch_sizes; //vector with number of chromosome junctions
-
-	chroms.reserve(TotalCHnum);
-	ch_sizes.reserve(TotalCHnum);
-	states.reserve(TotalCHnum);
-	ps.reserve(number_loci);
+// B counts of loci are the prefix sums of the difference array of the chromosome
+void Deme::getps(std::vector<double>& ps, int ch) const{
+	const int *difference = b_profile.data() + ch * (number_of_loci + 1);
+	int count = 0;
+	ps.reserve(number_of_loci);
+	for(int locus = 0; locus < number_of_loci; locus++){
+		count += difference[locus];
+		ps.push_back(count / (double)(deme_size * 2));
+	}
+}
 
-	for(int i = 0;i < deme_size;i++){
-		if(deme[i].getChromosomeBegining(0,ch)->second == 'A'){
-			states.push_back(0);
-		} else {
-			states.push_back(1);
-		}
-		if(deme[i].getChromosomeBegining(1,ch)->second == 'A'){
-			states.push_back(0);
-		} else {
-			states.push_back(1);
-		}
-		chroms.push_back(deme[i].getChromosomeBegining(0,ch));
-		chroms.push_back(deme[i].getChromosomeBegining(1,ch));
-		ch_sizes.push_back(deme[i].getNumberOfJunctions(0,ch));
-		ch_sizes.push_back(deme[i].getNumberOfJunctions(1,ch));
-	}
-	for(int i = 0;i < number_loci;i++){
-// 		I have to update states every iteration
-		for(int j = 0;j < TotalCHnum;j++){
-			if(chroms[j]->first == i){
-				if(chroms[j]->second == 'A'){
-					states[j] = 0;
-				} else {
-					states[j] = 1;
-				}
-				if(ch_sizes[j] != 0){
-					chroms[j]++;
-					ch_sizes[j] -= 1;
-				}
-			}
-		}
-		p = sum(states) / (double)(deme_size * 2);
-//		std::cout << "\n " << index << "-ch: " << i << " \n";
-//		std::cout << p << " = " << sum(states) << " / " << (double)(deme_size * 2) << std::endl;
-		ps.push_back(p);
+// offspring replace the whole deme, B blocks of all of them are added to the cleared profile
+void Deme::rebuildBProfile(){
+	std::fill(b_profile.begin(), b_profile.end(), 0);
+	for(int i = 0; i < deme_size; i++){
+		deme[i].addBBlocks(b_profile, 1);
 	}
 }
 
@@ -339,6 +336,77 @@ double Deme::getLD(){
 	return LD;
 }
 
+// haplotypes are columns of bits (1 is B) of every locus, returns the number of words of 64 haplotypes per locus
+int Deme::getHaplotypeColumns(std::vector<uint64_t>& columns, std::vector<double>& ps, int ch){
+	const int haplotypes = deme_size * 2, words = (haplotypes + 63) / 64;
+	columns.assign(number_of_loci * words, 0);
+	for(int i = 0; i < deme_size; i++){
+		for(int set = 0; set < 2; set++){
+			const int haplotype = 2 * i + set;
+			const uint64_t bit = uint64_t(1) << (haplotype % 64);
+			Junctions::iterator pos = deme[i].getChromosomeBegining(set, ch);
+			int junctions = deme[i].getNumberOfJunctions(set, ch);
+			for(int j = 0; j <= junctions; j++, ++pos){
+				if(pos->second != 'B'){
+					continue;
+				}
+				int end = (j < junctions) ? (pos + 1)->first : number_of_loci;
+				for(int locus = pos->first; locus < end; locus++){
+					columns[locus * words + haplotype / 64] |= bit;
+				}
+			}
+		}
+	}
+
+	ps.resize(number_of_loci);
+	for(int locus = 0; locus < number_of_loci; locus++){
+		int count = 0;
+		for(int w = 0; w < words; w++){
+			count += __builtin_popcountll(columns[locus * words + w]);
+		}
+		ps[locus] = count / double(haplotypes);
+	}
+	return words;
+}
+
+// pairs of loci are counted by popcounts of words of 64 haplotypes, r^2 of a monomorphic locus is 0
+void Deme::getPairwiseLD(std::vector<double>& D, std::vector<double>& r2, const std::vector<uint64_t>& columns,
+		const std::vector<double>& ps, int words, int i) const{
+	const double haplotypes = deme_size * 2;
+	D.resize(number_of_loci);
+	r2.resize(number_of_loci);
+	const uint64_t *column_i = columns.data() + i * words;
+	for(int j = 0; j < number_of_loci; j++){
+		const uint64_t *column_j = columns.data() + j * words;
+		int both_b = 0;
+		for(int w = 0; w < words; w++){
+			both_b += __builtin_popcountll(column_i[w] & column_j[w]);
+		}
+		double d = both_b / haplotypes - ps[i] * ps[j];
+		double variance = ps[i] * (1 - ps[i]) * ps[j] * (1 - ps[j]);
+		D[j] = d;
+		r2[j] = (variance > 0) ? d * d / variance : 0;
+	}
+}
+
+void Deme::addTracts(TractHistogram& a_tracts, TractHistogram& b_tracts){
+	std::vector<int> sizes;
+	for(int i = 0; i < deme_size; i++){
+		deme[i].getSizesOfABlocks(sizes);
+		a_tracts.add(sizes);
+		deme[i].getSizesOfBBlocks(sizes);
+		b_tracts.add(sizes);
+	}
+}
+
+// a single pass over junctions of every chromosome
+void Deme::getJunctionDensity(std::vector<long long>& counts, int bins) const{
+	counts.assign(deme[0].getNumberOfChromosomes() * bins, 0);
+	for(int i = 0; i < deme_size; i++){
+		deme[i].addJunctionPositions(counts, bins);
+	}
+}
+
 double Deme::getLD(double z,double varz,double varp){
 	double LD = 0, n = deme[0].getNumberOfLoci(0) * deme[0].getNumberOfChromosomes();
 
@@ -464,6 +532,48 @@ void Deme::streamHeterozygosity(std::ostream& stream) const{
 	return;
 }
 
+// a row of the matrix of every locus, D above the diagonal and r^2 below it; rows are computed
+// one at a time, the matrix is never held
+void Deme::streamLinkage(std::ostream& stream){
+	std::vector<uint64_t> columns;
+	std::vector<double> ps, D, r2, row(number_of_loci);
+	for(int ch = 0; ch < deme[0].getNumberOfChromosomes(); ch++){
+		int words = getHaplotypeColumns(columns, ps, ch);
+		for(int i = 0; i < number_of_loci; i++){
+			getPairwiseLD(D, r2, columns, ps, words, i);
+			for(int j = 0; j < number_of_loci; j++){
+				row[j] = roundForPrint((j < i) ? r2[j] : D[j]);
+			}
+			stream << x << "," << y << '\t' << ch + 1 << '\t' << i + 1 << '\t';
+			streamLine(stream, row);
+		}
+	}
+}
+
+void Deme::streamTracts(std::ostream& stream){
+	TractHistogram a_tracts(number_of_loci), b_tracts(number_of_loci);
+	addTracts(a_tracts, b_tracts);
+	for(const TractHistogram* tracts : {&a_tracts, &b_tracts}){
+		stream << x << "," << y << '\t' << (tracts == &a_tracts ? 'A' : 'B');
+		for(int bin = 0; bin < tracts->getNumberOfBins(); bin++){
+			stream << '\t' << tracts->getCount(bin);
+		}
+		stream << std::endl;
+	}
+}
+
+void Deme::streamJunctionDensity(std::ostream& stream, int bins) const{
+	std::vector<long long> counts;
+	getJunctionDensity(counts, bins);
+	for(int ch = 0; ch < deme[0].getNumberOfChromosomes(); ch++){
+		stream << x << "," << y << '\t' << ch + 1;
+		for(int bin = 0; bin < bins; bin++){
+			stream << '\t' << counts[ch * bins + bin];
+		}
+		stream << std::endl;
+	}
+}
+
 void Deme::readAllGenotypes(){
 	for(int i=0;i<deme_size;i++){
 		std::cerr << "Individual: " << i << " B proportion: " << deme[i].getBprop() << std::endl;
@@ -491,14 +601,6 @@ void Deme::readGenotypeFrequencies(){
 //  PRIVATE //
 // // // // //
 
-int Deme::sum(std::vector<bool>& ve){
-	int sum = 0;
-	for(unsigned int i = 0; i < ve.size();i++){
-		sum += ve[i];
-	}
-	return sum;
-}
-
 // CURENTLY DUPLICIT IN WORLD (as save_line)
 template<typename T>
 int Deme::streamLine(std::ostream& stream, std::vector<T>& vec) const{
@@ -512,3 +614,40 @@ int Deme::streamLine(std::ostream& stream, std::vector<T>& vec) const{
 double Deme::roundForPrint(double number) const{
 	return ((round(number * 1000000)) / 1000000);
 }
+
+// offspring of the deme, gametes of mothers[i] and fathers[i] form the individual i
+template <bool RECORD_PEDIGREE, bool RECOMBINATION>
+void Deme::breedOffspring(Individual *metademe, const std::vector<int>& mothers, const std::vector<int>& fathers){
+	std::vector<Chromosome> gamete1, gamete2;
+	std::vector<Chiasmata> chiasmata1, chiasmata2;
+	RecombinationBatch draws(chiasmata_table, recombination_maps);
+	draws.draw(context.random, 2 * deme_size * deme[0].getNumberOfChromosomes(), deme[0].getNumberOfLoci(0));
+	for(int i=0;i<deme_size;i++){
+		deme[mothers[i]].makeGamete<RECORD_PEDIGREE, RECOMBINATION>(gamete1, &chiasmata1, draws, packed_loci);
+		deme[fathers[i]].makeGamete<RECORD_PEDIGREE, RECOMBINATION>(gamete2, &chiasmata2, draws, packed_loci);
+		metademe[i] = Individual(gamete1, gamete2);
+		if(RECORD_PEDIGREE){
+			metademe[i].setPedigree(std::tuple<int, int, int>(x, y, i),
+									deme[mothers[i]].getBirthplace(),
+									deme[fathers[i]].getBirthplace(),
+									chiasmata1, chiasmata2);
+		}
+	}
+}
+
+// cumulative fitness of individuals, fitness is a function of all loci or of the selected ones only
+template <bool ALL_LOCI_SELECTED>
+void Deme::fillFitnessVector(std::vector<double>& fitnessVector){
+	double sum = 0, read_fitness = 0;
+	fitnessVector.reserve(deme_size);
+	for(int i = 0;i < deme_size;i++){
+		// getBprop > getHetProp ??
+		if(ALL_LOCI_SELECTED){
+			read_fitness = selection_model.getFitness(deme[i].getBprop());
+		} else {
+			read_fitness = selection_model.getFitness(deme[i].getSelectedHybridIndex(selected_loci));
+		}
+		sum += read_fitness;
+		fitnessVector.push_back(sum);
+	}
+}
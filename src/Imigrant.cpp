@@ -21,8 +21,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../include/Imigrant.h"
 #include "../include/RandomGenerators.h"
 
-Imigrant::Imigrant(const Context &context, int input_ch, int size, double input_lambda)
-	: context{context}
+Imigrant::Imigrant()
+	: context{nullptr}, recombination_maps{nullptr}
+{
+	lambda = 0;
+	number_of_chromosomes = 0;
+}
+
+Imigrant::Imigrant(const Context &context, int input_ch, int size, double input_lambda, const std::vector<RecombinationMap>* input_maps)
+	: context{&context}, recombination_maps{input_maps}
 {
 	lambda = input_lambda;
 	number_of_chromosomes = input_ch;
@@ -32,8 +39,8 @@ Imigrant::Imigrant(const Context &context, int input_ch, int size, double input_
 	}
 }
 
-Imigrant::Imigrant(const Context &context, char origin, int input_ch, int size, double input_lambda)
-	: context{context}
+Imigrant::Imigrant(const Context &context, char origin, int input_ch, int size, double input_lambda, const std::vector<RecombinationMap>* input_maps)
+	: context{&context}, recombination_maps{input_maps}
 {
 	lambda = input_lambda;
 	number_of_chromosomes = input_ch;
@@ -43,8 +50,8 @@ Imigrant::Imigrant(const Context &context, char origin, int input_ch, int size,
 	}
 }
 
-Imigrant::Imigrant(const Context &context, std::vector<Chromosome>& gamete, double input_lambda)
-	: context{context}
+Imigrant::Imigrant(const Context &context, std::vector<Chromosome>& gamete, double input_lambda, const std::vector<RecombinationMap>* input_maps)
+	: context{&context}, recombination_maps{input_maps}
 {
 	lambda = input_lambda;
 	number_of_chromosomes = gamete.size();
@@ -59,26 +66,79 @@ Imigrant::~Imigrant(){
 }
 
 void Imigrant::makeGamete(std::vector<Chromosome>& gamete){
-	gamete.clear();
-	gamete.reserve(number_of_chromosomes);
-	Chromosome CHtemp;
+	makeGamete(gamete, context->random);
+}
+
+// pool is bred in parallel, gametes are made using the generator of the breeding thread
+bool Imigrant::makeGamete(std::vector<Chromosome>& gamete, RandomGenerator& random){
+	std::vector<Recombination> recombination;
+	drawRecombination(recombination, random);
+	writeGamete(gamete, recombination);
+	return isCopy(recombination);
+}
+
+// random numbers are drawn in the same order as by Chromosome::makeRecombinant
+void Imigrant::drawRecombination(std::vector<Recombination>& recombination, RandomGenerator& random) const{
+	recombination.resize(number_of_chromosomes);
 	int chiasmata = 0;
 	for(int ch = 0; ch < number_of_chromosomes;ch++){
-		chiasmata = context.random.poisson(lambda);
+		chiasmata = random.poisson(lambda);
 //		cerr << " CH: " << ch+1 << " will get " << chiasmata << " chiasmata.\n";
-		genome[ch].makeRecombinant(CHtemp, chiasmata, context);
-		gamete.push_back(CHtemp);
+		recombination[ch].starts_by = random.tossAcoin();
+		genome[ch].drawRecombination(recombination[ch].positions, chiasmata, random,
+				(recombination_maps != nullptr) ? &(*recombination_maps)[ch] : nullptr);
+	}
+}
+
+bool Imigrant::isCopy(const std::vector<Recombination>& recombination) const{
+	for(int ch = 0; ch < number_of_chromosomes;ch++){
+		if(!recombination[ch].positions.empty() or recombination[ch].starts_by == 0){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+bool Imigrant::carriesB(const std::vector<Recombination>& recombination) const{
+	for(int ch = 0; ch < number_of_chromosomes;ch++){
+		if(genome[ch].inheritsB(recombination[ch].positions, recombination[ch].starts_by)){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void Imigrant::writeGamete(std::vector<Chromosome>& gamete, const std::vector<Recombination>& recombination) const{
+	gamete.resize(number_of_chromosomes);
+	for(int ch = 0; ch < number_of_chromosomes;ch++){
+		genome[ch].writeRecombinant(gamete[ch], recombination[ch].positions, recombination[ch].starts_by);
 	}
 }
 
+void Imigrant::inherit(const Imigrant& parent, const std::vector<Recombination>& recombination){
+	context = parent.context;
+	lambda = parent.lambda;
+	recombination_maps = parent.recombination_maps;
+	number_of_chromosomes = parent.number_of_chromosomes;
+	parent.writeGamete(genome, recombination);
+}
+
 int Imigrant::getNumberOfJunctions() const{
 	int junctions = 0;
 	for(int i=0;i<number_of_chromosomes;i++){
-		junctions = genome[i].getNumberOfJunctions();
+		junctions += genome[i].getNumberOfJunctions();
 	}
 	return junctions;
 }
 
+void Imigrant::addMemoryUsage(MemoryUsage& usage) const{
+	usage.individuals += sizeof(Imigrant);
+	usage.chromosomes += (genome.capacity() - genome.size()) * sizeof(Chromosome);
+	for(unsigned int ch = 0; ch < genome.size(); ch++){
+		usage.chromosomes += genome[ch].getMemoryUsage();
+	}
+}
+
 double Imigrant::getBprop() const{
 	int loci = genome[0].getResolution();
 	double prop = 0;
@@ -98,6 +158,21 @@ void Imigrant::getSizesOfBBlocks(std::vector<int>& sizes){
 	return;
 }
 
+void Imigrant::getSizesOfABlocks(std::vector<int>& sizes){
+	sizes.clear();
+	sizes.reserve(500);
+	for(int ch = 0;ch < number_of_chromosomes;ch++){
+		genome[ch].getSizesOfABlocks(sizes);
+	}
+	return;
+}
+
+void Imigrant::addJunctionPositions(std::vector<long long>& counts, int bins, int copies) const{
+	for(int ch = 0;ch < number_of_chromosomes;ch++){
+		genome[ch].addJunctionPositions(counts.data() + ch * bins, bins, copies);
+	}
+}
+
 int Imigrant::getNumberOfBBlocks(){
 	int number_of_blocks = 0, junctions = 0;
 	for(int ch = 0;ch < number_of_chromosomes;ch++){
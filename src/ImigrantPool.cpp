@@ -0,0 +1,102 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * reusable generation buffer of imigrants of 0D simulation
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <utility>
+
+#include "../include/ImigrantPool.h"
+
+ImigrantPool::ImigrantPool() : filled{0}, pure_b{-1} {
+}
+
+int ImigrantPool::size() const{
+	return filled;
+}
+
+Imigrant& ImigrantPool::operator[](int index){
+	return imigrants[index];
+}
+
+const Imigrant& ImigrantPool::operator[](int index) const{
+	return imigrants[index];
+}
+
+int ImigrantPool::getCopies(int index) const{
+	return copies[index];
+}
+
+double ImigrantPool::getFitness(int index) const{
+	return fitness[index];
+}
+
+Imigrant& ImigrantPool::push(int imigrant_copies){
+	if(filled == int(imigrants.size())){
+		imigrants.emplace_back();
+		copies.push_back(0);
+		fitness.push_back(0);
+	}
+	copies[filled] = imigrant_copies;
+	filled++;
+	return imigrants[filled - 1];
+}
+
+// copy assignment reuses junctions already allocated by the slot
+void ImigrantPool::push(const Imigrant& imigrant, int imigrant_copies){
+	push(imigrant_copies) = imigrant;
+}
+
+void ImigrantPool::setFitness(int index, double imigrant_fitness){
+	fitness[index] = imigrant_fitness;
+}
+
+void ImigrantPool::addCopies(int index, int imigrant_copies){
+	copies[index] += imigrant_copies;
+}
+
+void ImigrantPool::take(ImigrantPool& other, int index){
+	Imigrant& slot = push(other.copies[index]);
+	fitness[filled - 1] = other.fitness[index];
+	std::swap(slot, other.imigrants[index]);
+}
+
+void ImigrantPool::takeMerged(ImigrantPool& other, int index){
+	if(other.imigrants[index].isPureB()){
+		if(pure_b >= 0){
+			addCopies(pure_b, other.copies[index]);
+			return;
+		}
+		pure_b = filled;
+	}
+	take(other, index);
+}
+
+void ImigrantPool::clear(){
+	filled = 0;
+	pure_b = -1;
+}
+
+// reusable slots are counted as well, they hold their junctions
+void ImigrantPool::addMemoryUsage(MemoryUsage& usage) const{
+	usage.individuals += (imigrants.capacity() - imigrants.size()) * sizeof(Imigrant);
+	usage.individuals += copies.capacity() * sizeof(int) + fitness.capacity() * sizeof(double);
+	for(unsigned int i = 0; i < imigrants.size(); i++){
+		imigrants[i].addMemoryUsage(usage);
+	}
+}
@@ -18,319 +18,169 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <algorithm>
+#include <memory>
 
 #include "../include/Individual.h"
 #include "../include/RandomGenerators.h"
 
 /* DECLARATION */
 
-Individual::Individual() : context{nullptr} {
-	number_of_chromosomes = -1;
-	lambda = -1;
-	selected_loci = -1;
-}
-
-Individual::Individual( const Context *context,
-		char origin, int input_ch, int input_loci,
-		double input_lamda, int input_selected_loci,
-		std::tuple<int, int, int> ind_birthplace )
-	: context{context}
-{
-	number_of_chromosomes = input_ch;
-	lambda = input_lamda;
-	selected_loci = input_selected_loci;
-
-	genome[0].reserve(number_of_chromosomes);
-	genome[1].reserve(number_of_chromosomes);
-	if(origin == 'A' or origin == 'B'){
-		for(int i=0;i<number_of_chromosomes;i++){
-			genome[0].push_back(Chromosome(origin, input_loci));
-			genome[1].push_back(Chromosome(origin, input_loci));
-		}
-	} else {
-		for(int i=0;i<number_of_chromosomes;i++){
-			genome[0].push_back(Chromosome('A', input_loci));
-			genome[1].push_back(Chromosome('B', input_loci));
+Individual::Individual(){
+}
+
+Individual::Individual(char origin, int input_ch, int input_loci){
+	// syntax genome[set * number of chromosomes + chromosome]
+	genome.reserve(2 * input_ch);
+	for(int set = 0; set < 2; set++){
+		char material = (origin == 'A' or origin == 'B') ? origin : "AB"[set];
+		for(int i=0;i<input_ch;i++){
+			genome.push_back(Chromosome(material, input_loci));
 		}
 	}
-	birthplace = ind_birthplace;
-}
-
-Individual::Individual( const Context *context,
-		std::vector<Chromosome>& gamete1, std::vector<Chiasmata>& chaiasmata1,
-		std::vector<Chromosome>& gamete2, std::vector<Chiasmata>& chaiasmata2,
-		double input_lamda, int input_selected_loci,
-		std::tuple<int, int, int> ind_birthplace)
-	: context{context}
-{
-	number_of_chromosomes = gamete1.size();
-	selected_loci = input_selected_loci;
-	lambda = input_lamda;
-	birthplace = ind_birthplace;
-
-	genome[0].reserve(number_of_chromosomes);
-	genome[1].reserve(number_of_chromosomes);
-	chiasmata[0].reserve(number_of_chromosomes);
-	chiasmata[1].reserve(number_of_chromosomes);
-
-	for(int i=0; i<number_of_chromosomes; i++){
-		genome[0].push_back(gamete1[i]);
-		genome[1].push_back(gamete2[i]);
-		chiasmata[0].push_back(chaiasmata1[i]);
-		chiasmata[1].push_back(chaiasmata2[i]);
-	}
+}
+
+Individual::Individual(std::vector<Chromosome>& gamete1, std::vector<Chromosome>& gamete2){
+	genome.reserve(gamete1.size() + gamete2.size());
+	genome.insert(genome.end(), gamete1.begin(), gamete1.end());
+	genome.insert(genome.end(), gamete2.begin(), gamete2.end());
 }
 
 Individual::~Individual(){
-	genome[0].clear();genome[1].clear();
 }
 
 /* COMPUTIONG METHODS */
 
-void Individual::replace_chromozome(int set, int position, std::map <int, char>  input_chrom, int size){
-	genome[set][position] = Chromosome(input_chrom, size);
+void Individual::replace_chromozome(int set, int position, const Junctions& input_chrom, int size){
+	getChromosome(set, position) = Chromosome(input_chrom, size);
 }
 
-void Individual::makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>& chiasmata){
-	gamete.clear(); // variable for new gamete
-	chiasmata.clear();
-	gamete.reserve(number_of_chromosomes);
-	chiasmata.reserve(number_of_chromosomes);
-	std::vector<int> local_chiasmata; // vector of randomes chismas
-	Chromosome recombinant_ch; // temp chromosome
-	char last_material_s1, last_material_s2;
-	int rec_pos, numberOfChaisma, starts_by;
-
-/* for every chromosome... */
-	for(int i=0;i<number_of_chromosomes;i++){
-/* syntax genome[set][chromosome] */
-//		std::cout << genome[0][i].getResolution() << ' ';
-//		if(genome[0][i].getResolution() == 1){
-//			genome[3][i].getResolution();
-//		}
-		int loci = genome[0][i].getResolution();
-		numberOfChaisma = context->random.poisson(lambda);
-		starts_by = context->random.tossAcoin();
-
-/* no chiasma mean inheritance of whole one parent chromosome */
-		if(numberOfChaisma == 0){
-			chiasmata.push_back(Chiasmata());
-			gamete.push_back(genome[starts_by][i]);
-			continue;
-		}
-
-/* inicialization / restart of variables */
-		std::map<int, char>::const_iterator pos1=genome[0][i].begin();
-		std::map<int, char>::const_iterator pos2=genome[1][i].begin();
-		last_material_s1 = genome[0][i].read(0);
-		last_material_s2 = genome[1][i].read(0);
-		int last_roll = -1;
-
-		local_chiasmata.clear();
-		recombinant_ch.clear();
-		recombinant_ch.setResolution(loci);
-/* make sure that we start by 0 and do a crossover if not */
-		if(starts_by == 1){
-			local_chiasmata.push_back(0);
-			starts_by = 0;
-		}
-/* roll the chiasmata positions */
-		for(int index=0;index<numberOfChaisma;index++){
-			rec_pos = context->random.recombPosition(loci);
-			local_chiasmata.push_back(rec_pos);
-		}
-		sort(local_chiasmata.begin(), local_chiasmata.end());
-		// construct that removes double recombination events on the same spot
-		for(int index=0;index<numberOfChaisma;index++){
-			if(last_roll == local_chiasmata[index]){
-				local_chiasmata.erase (local_chiasmata.begin()+index,local_chiasmata.begin()+index+1);
-				index -= 2;
-				numberOfChaisma -= 2;
-				last_roll = -1;
-			} else {
-				last_roll = local_chiasmata[index];
-			}
+// individuals migrate between demes, gametes are made using the generator of the breeding deme,
+// chiasmata are recorded only if the vector for them is given (the backtrace is saved)
+void Individual::makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>* chiasmata, double lambda, RandomGenerator& random){
+	PoissonTable chiasmata_table(lambda);
+	RecombinationBatch draws(chiasmata_table);
+	draws.draw(random, getNumberOfChromosomes(), getNumberOfLoci(0));
+	if(chiasmata != nullptr){
+		if(lambda > 0){
+			makeGamete<true, true>(gamete, chiasmata, draws);
+		} else {
+			makeGamete<true, false>(gamete, chiasmata, draws);
 		}
-
-		chiasmata.push_back(Chiasmata(local_chiasmata));
-
-// I think that given the code above we could replace starts_by by 0 in both expressions bellow
-		if(local_chiasmata[0] != 0){
-			recombinant_ch.write(0,genome[starts_by][i].read(0));
+	} else {
+		if(lambda > 0){
+			makeGamete<false, true>(gamete, chiasmata, draws);
 		} else {
-			recombinant_ch.write(0,genome[(starts_by + 1) % 2][i].read(0));
+			makeGamete<false, false>(gamete, chiasmata, draws);
 		}
-		pos1++;
-		pos2++;
+	}
+}
 
-		for(int index=0;index<numberOfChaisma;index++){
-			rec_pos = local_chiasmata[index];
-			if(rec_pos == 0){
-				starts_by = (starts_by + 1) % 2;
-				continue;
-			}
-			if(rec_pos == loci){
-				continue;
-			}
+template <bool RECORD_CHIASMATA, bool RECOMBINATION>
+void Individual::makeGamete(std::vector<Chromosome>& gamete, std::vector<Chiasmata>* chiasmata, RecombinationBatch& draws,
+		const std::vector<SelectedLoci>* selected_loci){
+	gamete.resize(getNumberOfChromosomes()); // chromosomes of the previous gamete are overwritten, their junctions are reused
+	if(RECORD_CHIASMATA){
+		chiasmata->clear();
+		chiasmata->reserve(getNumberOfChromosomes());
+	}
+	const int *local_chiasmata; // sorted positions of chiasmata
+	int numberOfChaisma, starts_by;
 
-			if(starts_by==0){
-				while(pos1->first < rec_pos and pos1->first != genome[0][i].end()->first){
-					recombinant_ch.write(pos1->first,pos1->second);
-					last_material_s1 = pos1->second;
-					pos1++;
-				}
-				while(pos2->first <= rec_pos and pos2->first != genome[1][i].end()->first){
-					last_material_s2 = pos2->second;
-					pos2++;
-				}
-				if(last_material_s1 == 'A' and last_material_s2 == 'B'){
-					recombinant_ch.write(local_chiasmata[index],last_material_s2);
-				}
-				if(last_material_s1 == 'B' and last_material_s2 == 'A'){
-					recombinant_ch.write(local_chiasmata[index],last_material_s2);
-				}
-			} else {
-				while(pos2->first < rec_pos and pos2->first != genome[1][i].end()->first){
-					recombinant_ch.write(pos2->first,pos2->second);
-					last_material_s2 = pos2->second;
-					pos2++;
-				}
-				while(pos1->first <= rec_pos and pos1->first != genome[0][i].end()->first){
-					last_material_s1 = pos1->second;
-					pos1++;
-				}
-				if(last_material_s1 == 'A' and last_material_s2 == 'B'){
-					recombinant_ch.write(local_chiasmata[index],last_material_s1);
-				}
-				if(last_material_s1 == 'B' and last_material_s2 == 'A'){
-					recombinant_ch.write(local_chiasmata[index],last_material_s1);
-				}
+/* for every chromosome... */
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		numberOfChaisma = draws.next(starts_by, local_chiasmata);
+
+/* no chiasma mean inheritance of whole one parent chromosome */
+		if(!RECOMBINATION or numberOfChaisma == 0){
+			if(RECORD_CHIASMATA){
+				chiasmata->push_back(Chiasmata());
 			}
-			starts_by = (starts_by + 1) % 2;
+			gamete[i] = getChromosome(starts_by, i);
+			continue;
 		}
-		if(starts_by==0){
-			while(pos1->first != genome[0][i].end()->first){
-				recombinant_ch.write(pos1->first,pos1->second);
-				last_material_s1 = pos1->second;
-				pos1++;
-			}
-			while(pos2->first != genome[1][i].end()->first){
-				last_material_s2 = pos2->second;
-				pos2++;
-			}
-		} else {
-			while(pos2->first != genome[1][i].end()->first){
-				recombinant_ch.write(pos2->first,pos2->second);
-				last_material_s2 = pos2->second;
-				pos2++;
-			}
-			while(pos1->first != genome[0][i].end()->first){
-				last_material_s1 = pos1->second;
-				pos1++;
+
+		if(RECORD_CHIASMATA){
+			// the chiasma at 0 denotes gametes starting by the second set
+			chiasmata->push_back(Chiasmata(local_chiasmata, local_chiasmata + numberOfChaisma));
+			if(starts_by == 1){
+				chiasmata->back().add(0);
 			}
 		}
-		gamete.push_back(recombinant_ch);
+		Chromosome::writeRecombinant(gamete[i], getChromosome(0, i), getChromosome(1, i), local_chiasmata, numberOfChaisma, starts_by,
+				selected_loci == nullptr ? nullptr : &(*selected_loci)[i]);
 	}
 }
 
+template void Individual::makeGamete<true, true>(std::vector<Chromosome>&, std::vector<Chiasmata>*, RecombinationBatch&, const std::vector<SelectedLoci>*);
+template void Individual::makeGamete<true, false>(std::vector<Chromosome>&, std::vector<Chiasmata>*, RecombinationBatch&, const std::vector<SelectedLoci>*);
+template void Individual::makeGamete<false, true>(std::vector<Chromosome>&, std::vector<Chiasmata>*, RecombinationBatch&, const std::vector<SelectedLoci>*);
+template void Individual::makeGamete<false, false>(std::vector<Chromosome>&, std::vector<Chiasmata>*, RecombinationBatch&, const std::vector<SelectedLoci>*);
+
 int Individual::getBcount() const{
 	int count = 0;
-	for(int i=0;i<number_of_chromosomes;i++){
-		count += genome[0][i].countB();
-		count += genome[1][i].countB();
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		count += getChromosome(0, i).countB();
+		count += getChromosome(1, i).countB();
 	}
 	return count;
 }
 
 double Individual::getBprop() const{
-	int loci = genome[0][0].getResolution();
+	int loci = getChromosome(0, 0).getResolution();
 	double prop = 0;
-	for(int i=0;i<number_of_chromosomes;i++){
-		prop += genome[0][i].countB();
-		prop += genome[1][i].countB();
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		prop += getChromosome(0, i).countB();
+		prop += getChromosome(1, i).countB();
 	}
-//	std::cout << prop << " / (" << loci << " * 2 * " << number_of_chromosomes << " = ";
-	prop = prop / (loci*2*number_of_chromosomes);
+//	std::cout << prop << " / (" << loci << " * 2 * " << getNumberOfChromosomes() << " = ";
+	prop = prop / (loci*2*getNumberOfChromosomes());
 //	std::cout << prop << std::endl;
 	return prop;
 }
 
-double Individual::getSelectedHybridIndex(){
-	//TODO add constrain on selected loci ( (loci - selected) % (selected - 1) == 0)
-	int loci = genome[0][0].getResolution();
-	int neutural_block_size = 1 + ((loci - selected_loci) / (selected_loci - 1));
-	double prop = 0;
-	// std::cerr << "Block size : " << neutural_block_size << std::endl;
-
-	std::map<int, char>::const_iterator pos, next_pos;
-	for (int i=0; i<number_of_chromosomes; i++){
-		for (int ploidy = 0; ploidy < 2; ploidy++){
-			// std::cerr << "ploidy : " << ploidy << " chromosome : " << i << std::endl;
-
-			pos = genome[ploidy][i].begin();
-			next_pos = genome[ploidy][i].begin();
-			next_pos++;
-			if(pos->second == 'B'){
-				prop++;
-			}
-			while (next_pos != genome[ploidy][i].end()){
-				// std::cerr << pos->second << " block : " << pos->first << " to " << next_pos->first << std::endl;
-				if(pos->second == 'B'){
-					// std::cerr << "adding "
-					// 	<< (((next_pos->first - 1) / neutural_block_size) -
-					// 	    ((pos->first - 1) / neutural_block_size))
-					// 	<< " to prop" << std::endl;
-					prop += ((next_pos->first - 1) / neutural_block_size) -
-							((pos->first - 1) / neutural_block_size);
-				}
-				pos = next_pos;
-				next_pos++;
-			}
-			if(pos->second == 'B'){
-				// std::cerr << pos->second << " block : " << pos->first << " to " << loci << std::endl;
-				// std::cerr << "adding "
-				// 	<< (((loci - 1) / neutural_block_size) - ((pos->first - 1) / neutural_block_size))
-				// 	<< " to prop"  << std::endl;
-				prop += ((loci - 1) / neutural_block_size) -
-						((pos->first - 1) / neutural_block_size);
-			}
+// fitness of the individual is computed every generation, B of selected loci are counted by words
+double Individual::getSelectedHybridIndex(const std::vector<SelectedLoci>& selected_loci){
+	int count = 0, selected = 0;
+	for(unsigned int i = 0; i < genome.size(); i++){
+		const SelectedLoci& chromosome_loci = selected_loci[i % getNumberOfChromosomes()];
+		if(!genome[i].isPacked()){
+			genome[i].packSelected(chromosome_loci);
 		}
+		count += genome[i].countSelectedB(chromosome_loci);
+		selected += chromosome_loci.size();
 	}
-	// std::cerr << "B count: " << prop << std::endl;
-	prop = prop / (2 * selected_loci * number_of_chromosomes);
-	// std::cerr << "selected hybrid index : " << prop << std::endl;
-	return prop;
+	return double(count) / selected;
 }
 
 double Individual::getHetProp(){
 	bool write;
 	long number_of_het_loci = 0;
 	int last_pos = 0;
-	int loci = genome[0][0].getResolution();
+	int loci = getChromosome(0, 0).getResolution();
 
-	std::map<int, char>::const_iterator pos1, pos2;
+	Junctions::const_iterator pos1, pos2;
 
-	for(int i=0;i<number_of_chromosomes;i++){
-		pos1=genome[0][i].begin(); pos2=genome[1][i].begin();
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		pos1=getChromosome(0, i).begin(); pos2=getChromosome(1, i).begin();
 		last_pos = 0;
 		write = !(pos1->second == pos2->second);
 		pos1++; pos2++;
-		if((pos1 == genome[0][i].end()) & (pos2 == genome[1][i].end())){
+		if((pos1 == getChromosome(0, i).end()) & (pos2 == getChromosome(1, i).end())){
 			number_of_het_loci += loci * write;
 			continue;
 		}
 
-		if(pos1 == genome[0][i].end()){
+		if(pos1 == getChromosome(0, i).end()){
 			number_of_het_loci += getOneChromeHetero(write, pos2, i, 0);
 			continue;
 		}
 
-		if(pos2 == genome[1][i].end()){
+		if(pos2 == getChromosome(1, i).end()){
 			number_of_het_loci += getOneChromeHetero(write, pos1, i, 0);
 			continue;
 		}
 
-		while(pos1 != genome[0][i].end() and pos2 != genome[1][i].end()){
+		while(pos1 != getChromosome(0, i).end() and pos2 != getChromosome(1, i).end()){
 			if(pos1->first < pos2->first){
 				last_pos = pos1->first;
 				pos1++;
@@ -356,28 +206,28 @@ double Individual::getHetProp(){
 			std::cerr << "WARNING: Heterozygotisity counting problem (junc level)!";
 		}
 
-		if((pos1 == genome[0][i].end()) & (pos2 == genome[1][i].end())){
+		if((pos1 == getChromosome(0, i).end()) & (pos2 == getChromosome(1, i).end())){
 			number_of_het_loci += (loci - last_pos) * write;
 			continue;
 		}
 
-		if(pos1 == genome[0][i].end()){
+		if(pos1 == getChromosome(0, i).end()){
 			number_of_het_loci += getOneChromeHetero(write, pos2, i, last_pos);
 			continue;
 		}
 
-		if(pos2 == genome[1][i].end()){
+		if(pos2 == getChromosome(1, i).end()){
 			number_of_het_loci += getOneChromeHetero(write, pos1, i, last_pos);
 			continue;
 		}
 		std::cerr << "WARNING: Heterozygotisity counting problem (ch level)!\n";
 	}
-	return ((double)number_of_het_loci / (loci * number_of_chromosomes));
+	return ((double)number_of_het_loci / (loci * getNumberOfChromosomes()));
 }
 
 bool Individual::isPureA() const{
-	for(int i=0;i<number_of_chromosomes;i++){
-		if(genome[0][i].isPureA() and genome[1][i].isPureA()){
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		if(getChromosome(0, i).isPureA() and getChromosome(1, i).isPureA()){
 			continue;
 		}
 		return 0;
@@ -386,8 +236,8 @@ bool Individual::isPureA() const{
 }
 
 bool Individual::isPureB() const{
-	for(int i=0;i<number_of_chromosomes;i++){
-		if(genome[0][i].isPureB() and genome[1][i].isPureB()){
+	for(int i=0;i<getNumberOfChromosomes();i++){
+		if(getChromosome(0, i).isPureB() and getChromosome(1, i).isPureB()){
 			continue;
 		}
 		return 0;
@@ -395,30 +245,62 @@ bool Individual::isPureB() const{
 	return 1;
 }
 
-std::map< int, char >::iterator Individual::getChromosomeBegining(int set, int chrom){
-	return genome[set][chrom].begin();
+Junctions::iterator Individual::getChromosomeBegining(int set, int chrom){
+	return getChromosome(set, chrom).begin();
 }
 
 int Individual::getNumberOfJunctions(int set, int chrom){
-	return genome[set][chrom].getNumberOfJunctions();
+	return getChromosome(set, chrom).getNumberOfJunctions();
 }
 
 int Individual::getNumberOfJunctions(){
 	int sum = 0;
 	for(int set = 0; set < 2; set++){
-		for(int chrom = 0; chrom < number_of_chromosomes; chrom++){
-			sum += genome[set][chrom].getNumberOfJunctions();
+		for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
+			sum += getChromosome(set, chrom).getNumberOfJunctions();
 		}
 	}
 	return sum;
 }
 
+void Individual::addMemoryUsage(MemoryUsage& usage) const{
+	usage.individuals += sizeof(Individual);
+	if(pedigree){
+		usage.individuals += sizeof(Pedigree);
+		usage.chiasmata += (pedigree->chiasmata.capacity() - pedigree->chiasmata.size()) * sizeof(Chiasmata);
+		for(unsigned int i = 0; i < pedigree->chiasmata.size(); i++){
+			usage.chiasmata += pedigree->chiasmata[i].getMemoryUsage();
+		}
+	}
+	usage.chromosomes += (genome.capacity() - genome.size()) * sizeof(Chromosome);
+	for(unsigned int i = 0; i < genome.size(); i++){
+		usage.chromosomes += genome[i].getMemoryUsage();
+	}
+}
+
+void Individual::addBBlocks(std::vector<int>& difference, int weight) const{
+	for(int set = 0; set < 2; set++){
+		for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
+			const Chromosome& chromosome = getChromosome(set, chrom);
+			chromosome.addBBlocks(difference.data() + chrom * (chromosome.getResolution() + 1), weight);
+		}
+	}
+}
+
+void Individual::addJunctionPositions(std::vector<long long>& counts, int bins) const{
+	for(int set = 0; set < 2; set++){
+		for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
+			getChromosome(set, chrom).addJunctionPositions(counts.data() + chrom * bins, bins, 1);
+		}
+	}
+}
+
 void Individual::getSizesOfBBlocks(std::vector<int>& sizes){
 	sizes.clear();
 	sizes.reserve(500);
 	for(int set = 0; set < 2; set++){
-		for(int chrom = 0; chrom < number_of_chromosomes; chrom++){
-			genome[set][chrom].getSizesOfBBlocks(sizes);
+		for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
+			getChromosome(set, chrom).getSizesOfBBlocks(sizes);
 		}
 	}
 	return;
@@ -428,8 +310,8 @@ void Individual::getSizesOfABlocks(std::vector<int>& sizes){
 	sizes.clear();
 	sizes.reserve(500);
 	for(int set = 0; set < 2; set++){
-		for(int chrom = 0; chrom < number_of_chromosomes; chrom++){
-			genome[set][chrom].getSizesOfABlocks(sizes);
+		for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
+			getChromosome(set, chrom).getSizesOfABlocks(sizes);
 		}
 	}
 	return;
@@ -438,62 +320,56 @@ void Individual::getSizesOfABlocks(std::vector<int>& sizes){
 /* ASCII PLOTTING METHODS */
 
 void Individual::readGenotype(){
-	for(int i=0;i<number_of_chromosomes;i++){
+	for(int i=0;i<getNumberOfChromosomes();i++){
 		std::cout << "---Chromozome---set-1---number-" << i+1 << "---" << std::endl;
-		genome[0][i].showChromosome();
+		getChromosome(0, i).showChromosome();
 		std::cout << "---Chromozome---set-2---number-" << i+1 << "---" << std::endl;
-		genome[1][i].showChromosome();
+		getChromosome(1, i).showChromosome();
 	}
 	std::cout << std::endl;
 }
 
 /* COMUNICATION */
-void Individual::setNumberOfChromosomes(int ch){
-	number_of_chromosomes = ch;
-}
-
-void Individual::setLambda(double Rr){
-	lambda = Rr;
+void Individual::setPedigree(std::tuple<int,int,int> in_birthplace,
+		std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad){
+	pedigree = std::make_shared<const Pedigree>(Pedigree{in_birthplace, in_mum, in_dad, std::vector<Chiasmata>()});
 }
 
-void Individual::setParents(std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad){
-	mum = in_mum;
-	dad = in_dad;
+void Individual::setPedigree(std::tuple<int,int,int> in_birthplace,
+		std::tuple<int,int,int> in_mum, std::tuple<int,int,int> in_dad,
+		const std::vector<Chiasmata>& chiasmata1, const std::vector<Chiasmata>& chiasmata2){
+	std::vector<Chiasmata> in_chiasmata;
+	in_chiasmata.reserve(chiasmata1.size() + chiasmata2.size());
+	in_chiasmata.insert(in_chiasmata.end(), chiasmata1.begin(), chiasmata1.end());
+	in_chiasmata.insert(in_chiasmata.end(), chiasmata2.begin(), chiasmata2.end());
+	pedigree = std::make_shared<const Pedigree>(Pedigree{in_birthplace, in_mum, in_dad, std::move(in_chiasmata)});
 }
 
 int Individual::getNumberOfChromosomes() const{
-	return number_of_chromosomes;
-}
-
-double Individual::getLambda() const{
-	return lambda;
+	return genome.size() / 2;
 }
 
 int Individual::getNumberOfLoci(int ch) const{
-	return genome[0][ch].getResolution();
-}
-
-int Individual::getNumberOfSelectedLoci() const{
-	return selected_loci;
+	return getChromosome(0, ch).getResolution();
 }
 
 void Individual::getNumberOfLoci(std::vector<int>& ch) const{
 	ch.clear();
-	ch.reserve(number_of_chromosomes);
-	for(int i = 0; i < number_of_chromosomes; i++){
-		ch.push_back(genome[0][i].getResolution());
+	ch.reserve(getNumberOfChromosomes());
+	for(int i = 0; i < getNumberOfChromosomes(); i++){
+		ch.push_back(getChromosome(0, i).getResolution());
 	}
 }
 
 void Individual::getGenotype(std::vector<std::string>& hapl) const{
 	std::vector<int> blocks;
 	hapl.clear();
-	hapl.reserve(number_of_chromosomes*2);
-	for(int chrom = 0; chrom < number_of_chromosomes; chrom++){
+	hapl.reserve(getNumberOfChromosomes()*2);
+	for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
 		for(int ploidy = 0; ploidy < 2; ploidy++){
 			// TO CHANGE
 			blocks.clear();
-			genome[ploidy][chrom].getSizesOfBlocks(blocks);
+			getChromosome(ploidy, chrom).getSizesOfBlocks(blocks);
 			hapl.push_back(collapseBlocks(blocks));
 		}
 	}
@@ -501,32 +377,46 @@ void Individual::getGenotype(std::vector<std::string>& hapl) const{
 
 void Individual::getChiasmata(std::vector<std::string>& rec) const{
 	rec.clear();
-	rec.reserve(number_of_chromosomes*2);
-	for(int chrom = 0; chrom < number_of_chromosomes; chrom++){
+	rec.reserve(getNumberOfChromosomes()*2);
+	for(int chrom = 0; chrom < getNumberOfChromosomes(); chrom++){
 		for(int ploidy = 0; ploidy < 2; ploidy++){
-			rec.push_back(chiasmata[ploidy][chrom].collapse());
+			if(!pedigree or pedigree->chiasmata.empty()){
+				rec.push_back("");
+			} else {
+				rec.push_back(pedigree->chiasmata[ploidy * getNumberOfChromosomes() + chrom].collapse());
+			}
 		}
 	}
 }
 
+// individuals without pedigree (backtrace is not saved) were born nowhere
 std::tuple<int,int,int> Individual::getBirthplace() const {
-	return birthplace;
+	return pedigree ? pedigree->birthplace : std::tuple<int,int,int>(-1, -1, -1);
 }
 
 std::tuple<int,int,int> Individual::getMum() const {
-	return mum;
+	return pedigree ? pedigree->mum : std::tuple<int,int,int>(-1, -1, -1);
 }
 
 std::tuple<int,int,int> Individual::getDad() const {
-	return dad;
+	return pedigree ? pedigree->dad : std::tuple<int,int,int>(-1, -1, -1);
 }
+
 /* PRIVATE */
 
-int Individual::getOneChromeHetero(bool write, std::map<int, char>::const_iterator& pos, int chromosome, int last_pos){
+Chromosome& Individual::getChromosome(int set, int chrom){
+	return genome[set * getNumberOfChromosomes() + chrom];
+}
+
+const Chromosome& Individual::getChromosome(int set, int chrom) const{
+	return genome[set * getNumberOfChromosomes() + chrom];
+}
+
+int Individual::getOneChromeHetero(bool write, Junctions::const_iterator& pos, int chromosome, int last_pos){
 	int number_of_het_loci = 0;
-	int loci = genome[0][0].getResolution();
+	int loci = getChromosome(0, 0).getResolution();
 
-	while((pos != genome[0][chromosome].end()) and (pos != genome[1][chromosome].end())){
+	while((pos != getChromosome(0, chromosome).end()) and (pos != getChromosome(1, chromosome).end())){
 		number_of_het_loci += (pos->first - last_pos) * write;
 		last_pos = pos->first;
 		pos++;
@@ -0,0 +1,131 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * arena allocator of junctions released once per generation
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <new>
+#include <vector>
+#include <cstddef>
+
+#include "../include/JunctionArena.h"
+
+const std::size_t ARENA_BLOCK = 16 * 1024; // bytes of one block of the arena
+const std::size_t ARENA_ALIGNMENT = alignof(void*); // a word, freed arrays hold a pointer
+
+thread_local JunctionArena *active_arena = nullptr;
+
+// blocks of released arenas are reused by all arenas (i.e. by demes bred later or by other threads),
+// so the memory held does not grow with the number of generations
+struct SpareBlocks {
+	std::vector<char*> blocks;
+	~SpareBlocks(){
+		for(unsigned int i = 0; i < blocks.size(); i++){
+			::operator delete(blocks[i]);
+		}
+	}
+};
+SpareBlocks spare_blocks;
+
+char* takeBlock(){
+	char *block = nullptr;
+#ifdef _OPENMP
+	#pragma omp critical(junction_arena_blocks)
+#endif
+	{
+		if(!spare_blocks.blocks.empty()){
+			block = spare_blocks.blocks.back();
+			spare_blocks.blocks.pop_back();
+		}
+	}
+	if(block == nullptr){
+		block = static_cast<char*>(::operator new(ARENA_BLOCK));
+	}
+	return block;
+}
+
+void returnBlocks(std::vector<char*>& blocks){
+#ifdef _OPENMP
+	#pragma omp critical(junction_arena_blocks)
+#endif
+	{
+		spare_blocks.blocks.insert(spare_blocks.blocks.end(), blocks.begin(), blocks.end());
+	}
+	blocks.clear();
+}
+
+JunctionArena::JunctionArena() : used{ARENA_BLOCK}, free_arrays{} {
+}
+
+JunctionArena::~JunctionArena(){
+	reset();
+}
+
+void* JunctionArena::allocate(std::size_t bytes){
+	std::size_t words = (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+	bytes = words * ARENA_ALIGNMENT;
+	if(words <= SIZE_CLASSES and free_arrays[words - 1] != nullptr){
+		FreeNode *node = free_arrays[words - 1];
+		free_arrays[words - 1] = node->next;
+		return node;
+	}
+	if(bytes > ARENA_BLOCK){
+		large.push_back(::operator new(bytes));
+		return large.back();
+	}
+	if(used + bytes > ARENA_BLOCK){
+		blocks.push_back(takeBlock());
+		used = 0;
+	}
+	void *pointer = blocks.back() + used;
+	used += bytes;
+	return pointer;
+}
+
+// larger allocations are released by reset only
+void JunctionArena::deallocate(void* pointer, std::size_t bytes){
+	std::size_t words = (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+	if(words <= SIZE_CLASSES){
+		FreeNode *node = static_cast<FreeNode*>(pointer);
+		node->next = free_arrays[words - 1];
+		free_arrays[words - 1] = node;
+	}
+}
+
+void JunctionArena::reset(){
+	for(unsigned int i = 0; i < large.size(); i++){
+		::operator delete(large[i]);
+	}
+	large.clear();
+	returnBlocks(blocks);
+	used = ARENA_BLOCK;
+	for(int i = 0; i < SIZE_CLASSES; i++){
+		free_arrays[i] = nullptr;
+	}
+}
+
+JunctionArena* JunctionArena::active(){
+	return active_arena;
+}
+
+JunctionArena::Scope::Scope(JunctionArena* arena) : previous{active_arena} {
+	active_arena = arena;
+}
+
+JunctionArena::Scope::~Scope(){
+	active_arena = previous;
+}
@@ -0,0 +1,250 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * measuring wall and CPU time of phases of the simulation
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <sys/resource.h>
+
+#include "../include/Profiler.h"
+#include "../include/AllocationCounter.h"
+
+const char* const PHASE_NAMES[NUMBER_OF_PHASES] = {"migration", "breeding", "statistics", "output"};
+
+Profiler::Profiler() : current{}, allocations_start{0}, tracer{nullptr}, trace_start{0} {
+	current.generation = 1;
+}
+
+void Profiler::start(Phase phase){
+	wall_start = std::chrono::steady_clock::now();
+	cpu_start = std::clock();
+	allocations_start = AllocationCounter::count();
+	if(tracer != nullptr){
+		trace_start = tracer->now();
+	}
+}
+
+void Profiler::stop(Phase phase){
+	current.wall[phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+	current.cpu[phase] += double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+	current.allocations[phase] += AllocationCounter::count() - allocations_start;
+	if(tracer != nullptr){
+		tracer->record(PHASE_NAMES[phase], "phase", trace_start);
+	}
+}
+
+void Profiler::countBred(double individuals, double junctions){
+	current.individuals += individuals;
+	current.junctions += junctions;
+}
+
+void Profiler::countMemory(const MemoryUsage& usage){
+	current.memory = usage;
+}
+
+void Profiler::endGeneration(){
+	current.peak_rss_kb = getPeakRSS();
+	records.push_back(current);
+	int next_generation = current.generation + 1;
+	current = GenerationRecord{};
+	current.generation = next_generation;
+}
+
+void Profiler::setTracer(Tracer* phase_tracer){
+	tracer = phase_tracer;
+}
+
+PhaseTimes Profiler::getPhaseTimes() const{
+	GenerationRecord sum = sumOfGenerations();
+	return PhaseTimes{sum.wall[MIGRATION], sum.wall[BREEDING], sum.wall[STATISTICS], sum.wall[OUTPUT]};
+}
+
+double Profiler::getLastGenerationTime() const{
+	double time = 0;
+	if(!records.empty()){
+		for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+			time += records.back().wall[phase];
+		}
+	}
+	return time;
+}
+
+int Profiler::save(std::string filename, std::string format) const{
+	std::ofstream ofile(filename);
+	if(!ofile.is_open()){
+		std::cerr << "Error: unable to open file for profile: " << filename << std::endl;
+		return 1;
+	}
+	if(format == "json"){
+		streamJSON(ofile);
+		ofile.close();
+		return 0;
+	}
+	streamCSV(ofile);
+	ofile.close();
+
+	std::string demes_filename = filename.substr(0, filename.rfind(".csv")) + "_demes.csv";
+	std::ofstream demes_file(demes_filename);
+	if(!demes_file.is_open()){
+		std::cerr << "Error: unable to open file for profile: " << demes_filename << std::endl;
+		return 1;
+	}
+	streamDemesCSV(demes_file);
+	demes_file.close();
+	return 0;
+}
+
+  // // // // //
+ // PRIVATE  //
+// // // // //
+
+// all generations and the unfinished one, memory is the one of the last generation
+Profiler::GenerationRecord Profiler::sumOfGenerations() const{
+	GenerationRecord sum = current;
+	for(unsigned int i = 0; i < records.size(); i++){
+		for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+			sum.wall[phase] += records[i].wall[phase];
+			sum.cpu[phase] += records[i].cpu[phase];
+			sum.allocations[phase] += records[i].allocations[phase];
+		}
+		sum.individuals += records[i].individuals;
+		sum.junctions += records[i].junctions;
+	}
+	if(!records.empty()){
+		sum.memory = records.back().memory;
+	}
+	sum.peak_rss_kb = getPeakRSS();
+	return sum;
+}
+
+// ru_maxrss is in kilobytes on Linux, but in bytes on macOS
+long Profiler::getPeakRSS() const{
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0){
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+// throughput of breeding (count per second of breeding)
+double Profiler::perSecondOfBreeding(double count, const GenerationRecord& record) const{
+	return record.wall[BREEDING] > 0 ? count / record.wall[BREEDING] : 0;
+}
+
+void Profiler::streamJSON(std::ostream& stream) const{
+	GenerationRecord sum = sumOfGenerations();
+	stream << "{\"phases\": {";
+	for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+		stream << (phase ? ", " : "") << "\"" << PHASE_NAMES[phase] << "\": {\"wall_s\": "
+		<< sum.wall[phase] << ", \"cpu_s\": " << sum.cpu[phase];
+		if(AllocationCounter::enabled()){
+			stream << ", \"allocations\": " << sum.allocations[phase];
+		}
+		stream << "}";
+	}
+	stream << "},\n\"individuals\": " << sum.individuals << ", \"junctions\": " << sum.junctions
+	<< ", \"individuals_per_s\": " << perSecondOfBreeding(sum.individuals, sum)
+	<< ", \"junctions_per_s\": " << perSecondOfBreeding(sum.junctions, sum)
+	<< ", \"peak_rss_kb\": " << sum.peak_rss_kb
+	<< ",\n\"generations\": [\n";
+	for(unsigned int i = 0; i < records.size(); i++){
+		streamRecordJSON(stream, records[i]);
+		stream << (i + 1 < records.size() ? ",\n" : "\n");
+	}
+	stream << "]}\n";
+}
+
+void Profiler::streamRecordJSON(std::ostream& stream, const GenerationRecord& record) const{
+	stream << "{\"generation\": " << record.generation;
+	for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+		stream << ", \"" << PHASE_NAMES[phase] << "_wall_s\": " << record.wall[phase]
+		<< ", \"" << PHASE_NAMES[phase] << "_cpu_s\": " << record.cpu[phase];
+		if(AllocationCounter::enabled()){
+			stream << ", \"" << PHASE_NAMES[phase] << "_allocations\": " << record.allocations[phase];
+		}
+	}
+	stream << ", \"individuals\": " << record.individuals << ", \"junctions\": " << record.junctions
+	<< ", \"chromosome_bytes\": " << record.memory.chromosomes
+	<< ", \"chiasmata_bytes\": " << record.memory.chiasmata
+	<< ", \"individual_bytes\": " << record.memory.individuals
+	<< ", \"largest_deme_bytes\": " << record.memory.largest_deme
+	<< ", \"peak_rss_kb\": " << record.peak_rss_kb << ",\n \"demes\": [";
+	for(unsigned int i = 0; i < record.memory.demes.size(); i++){
+		const DemeMemoryUsage& deme = record.memory.demes[i];
+		stream << (i ? ", " : "") << "{\"deme\": " << deme.index << ", \"x\": " << deme.x << ", \"y\": " << deme.y
+		<< ", \"chromosome_bytes\": " << deme.chromosomes
+		<< ", \"chiasmata_bytes\": " << deme.chiasmata
+		<< ", \"individual_bytes\": " << deme.individuals << "}";
+	}
+	stream << "]}";
+}
+
+// one line per generation, the last line are totals (generation "total")
+void Profiler::streamCSV(std::ostream& stream) const{
+	stream << "generation";
+	for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+		stream << ',' << PHASE_NAMES[phase] << "_wall_s," << PHASE_NAMES[phase] << "_cpu_s";
+		if(AllocationCounter::enabled()){
+			stream << ',' << PHASE_NAMES[phase] << "_allocations";
+		}
+	}
+	stream << ",individuals,junctions,individuals_per_s,junctions_per_s"
+	<< ",chromosome_bytes,chiasmata_bytes,individual_bytes,largest_deme_bytes,peak_rss_kb\n";
+	for(unsigned int i = 0; i < records.size(); i++){
+		stream << records[i].generation;
+		streamRecordCSV(stream, records[i]);
+	}
+	stream << "total";
+	streamRecordCSV(stream, sumOfGenerations());
+}
+
+void Profiler::streamRecordCSV(std::ostream& stream, const GenerationRecord& record) const{
+	for(int phase = 0; phase < NUMBER_OF_PHASES; phase++){
+		stream << ',' << record.wall[phase] << ',' << record.cpu[phase];
+		if(AllocationCounter::enabled()){
+			stream << ',' << record.allocations[phase];
+		}
+	}
+	stream << ',' << record.individuals << ',' << record.junctions
+	<< ',' << perSecondOfBreeding(record.individuals, record)
+	<< ',' << perSecondOfBreeding(record.junctions, record)
+	<< ',' << record.memory.chromosomes << ',' << record.memory.chiasmata
+	<< ',' << record.memory.individuals << ',' << record.memory.largest_deme
+	<< ',' << record.peak_rss_kb << '\n';
+}
+
+// one line per deme and generation
+void Profiler::streamDemesCSV(std::ostream& stream) const{
+	stream << "generation,deme,x,y,chromosome_bytes,chiasmata_bytes,individual_bytes\n";
+	for(unsigned int i = 0; i < records.size(); i++){
+		for(unsigned int d = 0; d < records[i].memory.demes.size(); d++){
+			const DemeMemoryUsage& deme = records[i].memory.demes[d];
+			stream << records[i].generation << ',' << deme.index << ',' << deme.x << ',' << deme.y
+			<< ',' << deme.chromosomes << ',' << deme.chiasmata << ',' << deme.individuals << '\n';
+		}
+	}
+}
@@ -18,48 +18,121 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include "../include/RandomGenerators.h"
+#include "../include/RecombinationMap.h"
 
-RandomGenerator::RandomGenerator(int seed) {
-	std::cerr << "The SEED for random numbers is set to: " << seed << std::endl;
-	srand(seed);
+const double TWO_TO_53 = 9007199254740992.0;
+const double TWO_TO_26 = 67108864.0;
+const int POISSON_TABLE_LIMIT = 30; // exp(-lambda) of bigger means is too small for the transformation
+
+PoissonTable::PoissonTable(double lambda) : mean{lambda} {
+	if(lambda > POISSON_TABLE_LIMIT){
+		return;
+	}
+	double p = exp(-lambda);
+	double q = p;
+	cdf.push_back(q);
+	for(int k = 1; q < 1 - 1e-15 and k <= 4 * POISSON_TABLE_LIMIT; k++){
+		p = p * lambda / k;
+		q = q + p;
+		cdf.push_back(q);
+	}
+}
+
+// the smallest k with roll <= cdf[k], as the transformation of RandomGenerator::poisson
+int PoissonTable::sample(double roll) const{
+	int k = 0;
+	int last = cdf.size() - 1;
+	while(k < last and roll > cdf[k]){
+		k++;
+	}
+	return k;
+}
+
+bool PoissonTable::isTabulated() const{
+	return !cdf.empty();
+}
+
+double PoissonTable::getMean() const{
+	return mean;
+}
+
+// every generator has its own state, so generators of different demes can be used in parallel
+RandomGenerator::RandomGenerator(int seed) : engine(seed) {
 }
 
 
 // alternative, modulo bias is negligible if there is any
 int RandomGenerator::tossAcoin (){
-	return rand() % 2;
+	return engine() % 2;
 }
 
-// discrete uniform (integers between 0 and ceil - 1)
+// discrete uniform (integers between 1 and loci - 1), chiasmata are never on the first locus;
+// multiplication by the range is unbiased as rolls of the overhang (-range % range of them) are rejected
 int RandomGenerator::recombPosition(int loci){
-	if(loci == 1){
+	if(loci <= 2){
+		return loci - 1;
+	}
+	uint32_t range = loci - 1;
+	uint64_t product = uint64_t(engine()) * range;
+	if(uint32_t(product) < range){
+		uint32_t overhang = -range % range;
+		while(uint32_t(product) < overhang){
+			product = uint64_t(engine()) * range;
+		}
+	}
+	return 1 + (product >> 32);
+}
+
+// chiasmata are drawn independently (i.e. with replacement) as recombPosition does, two of them may fall
+// on the same position and cancel out in pairs when the recombinant is written; a chromosome of a single
+// locus has no position to recombine
+int RandomGenerator::sampleRecombPositions(int* positions, int count, int loci){
+	return sampleRecombPositions(positions, nullptr, count, loci);
+}
+
+int RandomGenerator::sampleRecombPositions(int* positions, const double* rolls, int count, int loci){
+	if(loci < 2){
 		return 0;
 	}
-	// this construction handles modulo bias; (of rand do uniform 0, RAND_MAX
-	// overhang of size RAND_MAX % loci would cause small disproportion of smaller
-	// values, not crutial for small numbers of locu, but very more important for big numbers
-	// similar construction is used in function bellow
-	int roll = RAND_MAX;
-	while(roll >= RAND_MAX - (RAND_MAX % loci)){
-		roll = rand();
+	orderStatistics(positions, rolls, count, loci - 1, nullptr);
+	return count;
+}
+
+// the map does not decrease, so it keeps order statistics sorted; equal positions are kept as in
+// the uniform sample
+int RandomGenerator::sampleRecombPositions(int* positions, const double* rolls, int count, const RecombinationMap& map){
+	orderStatistics(positions, rolls, count, 0, &map);
+	return count;
+}
+
+// positions are generated in decreasing order as the maxima of uniforms (the maximum of n uniforms is
+// the n-th root of a uniform), rolls are drawn from the engine if not given
+void RandomGenerator::orderStatistics(int* positions, const double* rolls, int count, int range, const RecombinationMap* map){
+	double maximum = 1;
+	for(int i = count - 1; i >= 0; i--){
+		double roll = (rolls != nullptr) ? rolls[i] : uniform();
+		maximum *= (i == 0) ? roll : pow(roll, 1.0 / (i + 1));
+		positions[i] = (map != nullptr) ? map->position(maximum) : 1 + int(maximum * range);
 	}
-	return (roll % (loci-1)) + 1;
 }
 
-// continuus unifrom; corrected for modulo bias
+// continuous uniform in [0, 1) with resolution of 2^-53 (all bits of the mantissa)
 double RandomGenerator::uniform(){
-	int roll = RAND_MAX;
-	int detailness = 1000000;
-	while(roll >= RAND_MAX - (RAND_MAX % detailness)){
-		roll = rand();
-	}
-	return double(roll % detailness) / detailness;
+	uint32_t high = engine() >> 5;
+	uint32_t low = engine() >> 6;
+	return (high * TWO_TO_26 + low) / TWO_TO_53;
 }
 
 // Poisson (by transformation from uniform)
 int RandomGenerator::poisson(double lambda){
+	// exp(-lambda) of big means is too small for the transformation (i.e. offspring of a weighted pool)
+	if(lambda > 30){
+		std::poisson_distribution<int> distribution(lambda);
+		return distribution(engine);
+	}
 	int result = 0;
 	double q = exp(-lambda);
 	double p = q;
@@ -71,3 +144,59 @@ int RandomGenerator::poisson(double lambda){
 	}
 	return result;
 }
+
+int RandomGenerator::poisson(const PoissonTable& table){
+	if(!table.isTabulated()){
+		return poisson(table.getMean());
+	}
+	return table.sample(uniform());
+}
+
+int RandomGenerator::binomial(int trials, double probability){
+	std::binomial_distribution<int> distribution(trials, probability);
+	return distribution(engine);
+}
+
+int RandomGenerator::seed(){
+	return engine() >> 1;
+}
+
+// the buffer is shared by all generators used by the thread (i.e. of demes bred by the thread)
+thread_local std::vector<uint32_t> engine_words;
+
+const uint32_t* RandomGenerator::fillWords(int count){
+	engine_words.resize(count);
+	for(int i = 0; i < count; i++){
+		engine_words[i] = engine();
+	}
+	return engine_words.data();
+}
+
+void RandomGenerator::fillUniform(double* rolls, int count){
+	const uint32_t *words = fillWords(2 * count);
+	for(int i = 0; i < count; i++){
+		rolls[i] = ((words[2 * i] >> 5) * TWO_TO_26 + (words[2 * i + 1] >> 6)) / TWO_TO_53;
+	}
+}
+
+// every word of the engine gives 32 coins
+void RandomGenerator::fillCoins(char* coins, int count){
+	const uint32_t *words = fillWords((count + 31) / 32);
+	for(int i = 0; i < count; i++){
+		coins[i] = (words[i / 32] >> (i % 32)) & 1;
+	}
+}
+
+void RandomGenerator::fillPoisson(int* counts, int count, const PoissonTable& table){
+	if(!table.isTabulated()){
+		for(int i = 0; i < count; i++){
+			counts[i] = poisson(table.getMean());
+		}
+		return;
+	}
+	std::vector<double> rolls(count);
+	fillUniform(rolls.data(), count);
+	for(int i = 0; i < count; i++){
+		counts[i] = table.sample(rolls[i]);
+	}
+}
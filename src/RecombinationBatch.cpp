@@ -0,0 +1,85 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * random draws of recombination of one generation of a deme
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "../include/RecombinationBatch.h"
+
+const std::vector<RecombinationMap> UNIFORM_RECOMBINATION; // no maps, chromosomes recombine uniformly
+
+RecombinationBatch::RecombinationBatch(const PoissonTable& table)
+	: RecombinationBatch(table, UNIFORM_RECOMBINATION) {
+}
+
+RecombinationBatch::RecombinationBatch(const PoissonTable& table, const std::vector<RecombinationMap>& maps)
+	: chiasmata_table(table), recombination_maps(maps), current{0}, current_position{0} {
+}
+
+// numbers of chiasmata, then sets the gametes start by and then sorted positions of chiasmata,
+// chiasmata of a chromosome may share a position (they cancel out in pairs)
+void RecombinationBatch::draw(RandomGenerator& random, int chromosomes, int loci){
+	counts.resize(chromosomes);
+	coins.resize(chromosomes);
+	if(chiasmata_table.getMean() > 0){
+		random.fillPoisson(counts.data(), chromosomes, chiasmata_table);
+	} else {
+		std::fill(counts.begin(), counts.end(), 0);
+	}
+	random.fillCoins(coins.data(), chromosomes);
+
+	int total = 0;
+	for(int i = 0; i < chromosomes; i++){
+		total += counts[i];
+	}
+	rolls.resize(total);
+	random.fillUniform(rolls.data(), total);
+	positions.resize(total);
+	int first = 0;
+	if(recombination_maps.empty()){
+		for(int i = 0; i < chromosomes; i++){
+			counts[i] = random.sampleRecombPositions(positions.data() + first, rolls.data() + first, counts[i], loci);
+			first += counts[i];
+		}
+	} else {
+		// gametes take chromosomes in order, so the i-th drawn chromosome is i % (chromosomes of a gamete)
+		int maps = recombination_maps.size();
+		for(int i = 0; i < chromosomes; i++){
+			counts[i] = random.sampleRecombPositions(positions.data() + first, rolls.data() + first, counts[i], recombination_maps[i % maps]);
+			first += counts[i];
+		}
+	}
+	positions.resize(first);
+	current = 0;
+	current_position = 0;
+}
+
+int RecombinationBatch::next(int& starts_by, const int*& chiasmata){
+	int number_of_chiasmata = counts[current];
+	starts_by = coins[current];
+	chiasmata = positions.data() + current_position;
+	current_position += number_of_chiasmata;
+	current++;
+	return number_of_chiasmata;
+}
+
+double RecombinationBatch::getLambda() const{
+	return chiasmata_table.getMean();
+}
@@ -0,0 +1,134 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * genetic maps of chromosomes with non-uniform recombination
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "../include/RecombinationMap.h"
+
+// intervals are clipped to positions 1 .. loci - 1, intervals of zero rate are dropped
+RecombinationMap::RecombinationMap(const std::vector<int>& map_starts, const std::vector<double>& rates, int loci){
+	std::vector<double> weights;
+	double total = 0;
+	for(unsigned int i = 0; i < map_starts.size(); i++){
+		int start = std::max(map_starts[i], 1);
+		int end = (i + 1 < map_starts.size()) ? std::min(map_starts[i + 1], loci) : loci;
+		if(rates[i] < 0){
+			throw std::runtime_error("Negative rate of recombination map at position " + std::to_string(map_starts[i]) + ".");
+		}
+		if(rates[i] == 0 or start >= end){
+			continue;
+		}
+		starts.push_back(start);
+		ends.push_back(end);
+		weights.push_back(rates[i] * (end - start));
+		total += weights.back();
+	}
+	if(total == 0){
+		throw std::runtime_error("Recombination map has no position with non-zero rate.");
+	}
+
+	double cumulative = 0;
+	for(unsigned int i = 0; i < weights.size(); i++){
+		cumulative += weights[i];
+		cdf.push_back(cumulative / total);
+	}
+	cdf.back() = 1; // rolls are below 1, the search always ends
+
+	guide.resize(cdf.size());
+	int interval = 0;
+	for(unsigned int j = 0; j < guide.size(); j++){
+		while(cdf[interval] <= double(j) / guide.size()){
+			interval++;
+		}
+		guide[j] = interval;
+	}
+}
+
+std::vector<RecombinationMap> RecombinationMap::load(const std::string& file_name, int chromosomes, int loci){
+	std::vector<RecombinationMap> maps;
+	if(file_name.empty()){
+		return maps;
+	}
+	std::ifstream map_file(file_name);
+	if(!map_file){
+		throw std::runtime_error("Can not open recombination map: " + file_name + "; It does not exist or you do not have premssion to read it.");
+	}
+
+	std::vector<std::vector<int> > starts(chromosomes);
+	std::vector<std::vector<double> > rates(chromosomes);
+	std::string line;
+	int line_number = 0;
+	while(getline(map_file, line)){
+		line_number++;
+		line = line.substr(0, line.find('#'));
+		if(line.find_first_not_of(" \t\r") == std::string::npos){
+			continue;
+		}
+		std::istringstream fields(line);
+		int chromosome, start;
+		double rate;
+		if(!(fields >> chromosome >> start >> rate)){
+			throw std::runtime_error("Line " + std::to_string(line_number) + " of recombination map " + file_name +
+								" is not \"chromosome start rate\".");
+		}
+		if(chromosome < 1 or chromosome > chromosomes){
+			throw std::runtime_error("Recombination map " + file_name + " refers to chromosome " + std::to_string(chromosome) +
+								", but there are " + std::to_string(chromosomes) + " chromosomes.");
+		}
+		if(!starts[chromosome - 1].empty() and start <= starts[chromosome - 1].back()){
+			throw std::runtime_error("Intervals of chromosome " + std::to_string(chromosome) + " of recombination map " +
+								file_name + " are not sorted by their start.");
+		}
+		starts[chromosome - 1].push_back(start);
+		rates[chromosome - 1].push_back(rate);
+	}
+
+	for(int ch = 0; ch < chromosomes; ch++){
+		if(starts[ch].empty()){
+			starts[ch].push_back(1);
+			rates[ch].push_back(1);
+		}
+		maps.push_back(RecombinationMap(starts[ch], rates[ch], loci));
+	}
+	return maps;
+}
+
+int RecombinationMap::position(double roll) const{
+	int interval = guide[int(roll * guide.size())];
+	while(cdf[interval] <= roll){
+		interval++;
+	}
+	double below = (interval == 0) ? 0 : cdf[interval - 1];
+	int position = starts[interval] + int((roll - below) / (cdf[interval] - below) * (ends[interval] - starts[interval]));
+	return std::min(position, ends[interval] - 1);
+}
+
+int RecombinationMap::getNumberOfPositions() const{
+	int positions = 0;
+	for(unsigned int i = 0; i < starts.size(); i++){
+		positions += ends[i] - starts[i];
+	}
+	return positions;
+}
@@ -0,0 +1,99 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * layout of loci under selection
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../include/SelectedLoci.h"
+
+// (loci - selected) % (selected - 1) == 0 is checked by the setting, a single selected locus is the first one
+SelectedLoci::SelectedLoci(int loci, int selected_loci) : words(loci / PACKED_LOCI + 1, 0), selected{0} {
+	int spacing = (selected_loci > 1) ? 1 + (loci - selected_loci) / (selected_loci - 1) : loci;
+	std::vector<int> positions;
+	for(int i = 0; i < selected_loci; i++){
+		positions.push_back(i * spacing);
+	}
+	build(positions);
+}
+
+SelectedLoci::SelectedLoci(int loci, const std::vector<int>& positions) : words(loci / PACKED_LOCI + 1, 0), selected{0} {
+	for(unsigned int i = 0; i < positions.size(); i++){
+		if(positions[i] < 0 or positions[i] >= loci or (i > 0 and positions[i - 1] >= positions[i])){
+			throw std::runtime_error("Selected positions have to be sorted distinct loci of a chromosome of " +
+									std::to_string(loci) + " loci.");
+		}
+	}
+	build(positions);
+}
+
+std::vector<SelectedLoci> SelectedLoci::layout(int chromosomes, int loci, int selected_loci,
+		const std::vector<std::vector<int> >& positions){
+	std::vector<SelectedLoci> layouts;
+	if(positions.empty()){
+		layouts.assign(chromosomes, SelectedLoci(loci, selected_loci));
+		return layouts;
+	}
+	if(positions.size() != 1 and int(positions.size()) != chromosomes){
+		throw std::runtime_error("Selected positions are listed for " + std::to_string(positions.size()) +
+								" chromosomes, expected one list or a list for each of " + std::to_string(chromosomes) + ".");
+	}
+	for(int ch = 0; ch < chromosomes; ch++){
+		layouts.push_back(SelectedLoci(loci, positions[ch % positions.size()]));
+	}
+	return layouts;
+}
+
+int SelectedLoci::size() const{
+	return selected;
+}
+
+bool SelectedLoci::isPackable() const{
+	return selected <= PACKED_LOCI;
+}
+
+// positions up to loci (included) are ranked
+int SelectedLoci::rank(int position) const{
+	int word = position / PACKED_LOCI;
+	return ranks[word] + __builtin_popcountll(words[word] & bits(0, position % PACKED_LOCI));
+}
+
+uint64_t SelectedLoci::bits(int from, int to){
+	if(from >= to){
+		return 0;
+	}
+	return (~uint64_t(0) >> (PACKED_LOCI - (to - from))) << from;
+}
+
+  // // // // //
+ // PRIVATE  //
+// // // // //
+
+void SelectedLoci::build(const std::vector<int>& positions){
+	for(unsigned int i = 0; i < positions.size(); i++){
+		words[positions[i] / PACKED_LOCI] |= uint64_t(1) << (positions[i] % PACKED_LOCI);
+	}
+	selected = positions.size();
+	ranks.assign(words.size(), 0);
+	for(unsigned int word = 1; word < words.size(); word++){
+		ranks[word] = ranks[word - 1] + __builtin_popcountll(words[word - 1]);
+	}
+}
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <iomanip>
 
 #include "../include/SettingHandler.h"
+#include "../include/Position.h"
 
 SettingHandler::SettingHandler(std::string filename) {
 	std::ifstream setting_file(filename);
@@ -82,6 +83,11 @@ SimulationSetting SettingHandler::getSimualtionSetting(int simulation_index) con
 
 	mySetting.file_to_save = file_to_save;
 	mySetting.type_of_save = type_of_save;
+	mySetting.type_of_profile = type_of_profile;
+	mySetting.type_of_trace = type_of_trace;
+	mySetting.type_of_pool = type_of_pool;
+	mySetting.recombination_map = recombination_map;
+	mySetting.selected_positions = selected_positions;
 
 	mySetting.dimension = dimension;
 	mySetting.up_down_demes = up_down_demes;
@@ -112,6 +118,7 @@ void SettingHandler::printParameters() const{
 			<< std::setw(15) << "delay"
 			<< std::setw(15) << "replicates"
 			<< std::setw(15) << "saves"
+			<< std::setw(15) << "threads"
 			<< std::endl;
 
 	for(int val_index = 0; val_index < number_of_simulations; val_index++){
@@ -139,6 +146,8 @@ void SettingHandler::printParameters() const{
 		if(val_index == 0){ std::cerr << replicates;}
 		std::cerr << std::setw(15);
 		checker += printVectorValue(val_index, saves);
+		std::cerr << std::setw(15);
+		checker += printVectorValue(val_index, threads);
 		std::cerr << std::endl;
 		if(checker == 0){
 			return;
@@ -205,7 +214,13 @@ int SettingHandler::parseSetting(std::ifstream& myfile){
 					switcher = "read_value"; // symbol = switches to reading values
 					continue;
 				}
-				if(parameter.substr(0,16) == "NAMEofOUTPUTfile" or parameter.substr(0,16) == "TYPEofOUTPUTfile"){
+				if(parameter == "RECOMBINATIONmap" or parameter == "SELECTEDpositions"){ // a path to a file or lists of loci
+					if(!isspace(line[i])){
+						number += line[i];
+					}
+					continue;
+				}
+				if(parameter.substr(0,16) == "NAMEofOUTPUTfile" or parameter.substr(0,16) == "TYPEofOUTPUTfile" or parameter == "PROFILE" or parameter == "TRACE" or parameter == "TYPEofPOOL"){
 					if(line[i] == '.' or line[i] == '~' or line[i] == '*' or line[i] == '/' or line[i] == '\\'){
 						throw std::runtime_error("Symbols '.' '*' '~' and '/' are not allowed in any parameter value.");
 					}
@@ -249,6 +264,36 @@ int SettingHandler::parseSetting(std::ifstream& myfile){
 						parameter.clear();
 						continue;
 					}
+					if(parameter == "PROFILE"){
+						type_of_profile = number;
+						number.clear();
+						parameter.clear();
+						continue;
+					}
+					if(parameter == "TRACE"){
+						type_of_trace = number;
+						number.clear();
+						parameter.clear();
+						continue;
+					}
+					if(parameter == "TYPEofPOOL"){
+						type_of_pool = number;
+						number.clear();
+						parameter.clear();
+						continue;
+					}
+					if(parameter == "RECOMBINATIONmap"){
+						recombination_map = number;
+						number.clear();
+						parameter.clear();
+						continue;
+					}
+					if(parameter == "SELECTEDpositions"){
+						parseSelectedPositions(number);
+						number.clear();
+						parameter.clear();
+						continue;
+					}
 					if(parameter.substr(0,5) == "WORLD"){
 
 						return parseWorldDefinition(line);
@@ -286,6 +331,31 @@ int SettingHandler::parseSetting(std::ifstream& myfile){
 	return 0;
 }
 
+// loci of a chromosome are separated by ',' and chromosomes by ';' (e.g. 0,13,26,39;5,20)
+void SettingHandler::parseSelectedPositions(const std::string& value){
+	std::string number;
+	selected_positions.assign(1, std::vector<int>());
+	for(unsigned int i = 0; i <= value.size(); i++){
+		if(i < value.size() and isdigit(value[i])){
+			number += value[i];
+			continue;
+		}
+		if(i < value.size() and value[i] != ',' and value[i] != ';'){
+			throw std::runtime_error("Unexpected symbol '" + std::string(1, value[i]) + "' in SELECTEDpositions.");
+		}
+		if(!number.empty()){
+			selected_positions.back().push_back(stoi(number));
+			number.clear();
+		}
+		if(i < value.size() and value[i] == ';'){
+			selected_positions.push_back(std::vector<int>());
+		}
+	}
+	if(selected_positions.back().empty()){
+		selected_positions.pop_back();
+	}
+}
+
 int SettingHandler::parseWorldDefinition(std::string& line){
 	int switcher = 0, n = 0;
 	std::string type, number;
@@ -338,15 +408,13 @@ int SettingHandler::parseWorldDefinition(std::string& line){
 		if(switcher == 4){
 			if(isdigit(line[i])){
 				switcher = 5;
-				number.push_back((line[i]));
-				if(i+1 < line.size()){
-					continue;
-				}
 			}
 		}
 		if(switcher == 5){
-			if(isdigit(line[i]) and i+1 < line.size()){
+			if(isdigit(line[i])){
 				number.push_back((line[i]));
+			}
+			if(isdigit(line[i]) and i+1 < line.size()){
 				continue;
 			} else {
 				if(type == "HybridZone"){
@@ -509,6 +577,10 @@ void SettingHandler::parameterSave(std::string& parameter, double value){
 		replicates = int(value);
 		return;
 	}
+	if(parameter == "THREADS"){
+		threads.push_back(int(value));
+		return;
+	}
 
 	std::cerr << "Warning: unknown parameter: " << parameter << std::endl;
 	return;
@@ -537,6 +609,7 @@ void SettingHandler::updateNumberOfSimulations(){
 			lambda.size() *
 			delay.size() *
 			saves.size() *
+			threads.size() *
 			replicates;
 	return;
 }
@@ -601,6 +674,10 @@ char SettingHandler::setParameterOfSetting(SimulationSetting& mySetting, std::st
 		mySetting.delay = delay[index];
 		return 'D';
 	}
+	if(parameter == "THREADS"){
+		mySetting.threads = threads[index];
+		return 't';
+	}
 	return '?';
 }
 
@@ -652,7 +729,7 @@ void SettingHandler::checkParameters(){
 	bool correct_type = 1;
 
 	if(!file_name_patten.empty()){
-		std::vector<std::string> types{"complete", "summary", "hybridIndices", "hybridIndicesJunctions", "blocks", "raspberrypi", "backtrace"};
+		std::vector<std::string> types{"complete", "summary", "hybridIndices", "hybridIndicesJunctions", "blocks", "raspberrypi", "backtrace", "linkage", "tracts", "junctionDensity"};
 		for(unsigned int i = 0; i < types.size(); i++){
 			if(type_of_save == types[i]){
 				correct_type = !correct_type;
@@ -665,6 +742,23 @@ void SettingHandler::checkParameters(){
 		}
 	}
 
+	for(unsigned int i = 0; i < loci.size(); i++){
+		if(loci[i] > MAX_LOCI){
+			throw std::runtime_error("LOCI (" + std::to_string(loci[i]) + ") exceed " + std::to_string(MAX_LOCI) +
+								", the maximum of positions of this build. Build conjunction by make WIDE_POSITIONS=1.");
+		}
+	}
+
+	if(type_of_profile != "none" and type_of_profile != "json" and type_of_profile != "csv"){
+		throw std::runtime_error("Type of profile is invalid: " + type_of_profile);
+	}
+	if(type_of_trace != "none" and type_of_trace != "chrome"){
+		throw std::runtime_error("Type of trace is invalid: " + type_of_trace);
+	}
+	if(type_of_pool != "individuals" and type_of_pool != "weighted"){
+		throw std::runtime_error("Type of 0D pool is invalid: " + type_of_pool);
+	}
+
 	for(unsigned int i = 0; i < saves.size(); i++){
 		if(saves[i] > 0){
 			if(file_name_patten.empty()){
@@ -727,6 +821,34 @@ void SettingHandler::checkParameters(){
 		}
 	}
 
+	if(!selected_positions.empty()){
+		if(selected_loci.size() > 1 or selected_loci[0] != 0){
+			throw std::runtime_error("SELECTEDloci and SELECTEDpositions can not be set both.");
+		}
+		for(unsigned int i = 0; i < selected_positions.size(); i++){
+			if(selected_positions[i].empty()){
+				throw std::runtime_error("SELECTEDpositions lists a chromosome without selected loci.");
+			}
+			for(unsigned int j = 1; j < selected_positions[i].size(); j++){
+				if(selected_positions[i][j - 1] >= selected_positions[i][j]){
+					throw std::runtime_error("SELECTEDpositions of a chromosome have to be sorted and distinct.");
+				}
+			}
+			for(unsigned int j = 0; j < loci.size(); j++){
+				if(selected_positions[i].back() >= loci[j]){
+					throw std::runtime_error("SELECTEDpositions " + std::to_string(selected_positions[i].back()) +
+										" is not a locus of a chromosome of " + std::to_string(loci[j]) + " loci.");
+				}
+			}
+		}
+		for(unsigned int j = 0; j < chrom.size() and selected_positions.size() > 1; j++){
+			if(int(selected_positions.size()) != chrom[j]){
+				throw std::runtime_error("SELECTEDpositions lists " + std::to_string(selected_positions.size()) +
+									" chromosomes, but NUMBERofCHROMOSOMES is " + std::to_string(chrom[j]) + ".");
+			}
+		}
+	}
+
 	if(sel.size() == 0){
 		throw std::runtime_error("The selection pressure was not set.");
 	}
@@ -746,6 +868,12 @@ void SettingHandler::checkParameters(){
 		}
 	}
 
+	for(unsigned int i = 0; i < threads.size(); i++){
+		if(threads[i] < 1){
+			throw std::runtime_error("The number of THREADS has to be at least 1.");
+		}
+	}
+
 	if((unsigned)number_of_simulations != seed.size()){
 		std::cerr << "The number of seeds is not equal to number of simulation\n";
 		std::cerr << "Possible SEED: none (seeds will be random generated using time)\n";
@@ -818,12 +946,32 @@ void SettingHandler::fillDefault(){
 	}
 
 	if(selected_loci.empty()){
-		std::cerr << "Assuming all loci under selection.\n";
+		if(selected_positions.empty()){
+			std::cerr << "Assuming all loci under selection.\n";
+		}
 		selected_loci.push_back(0);
 		parameters_in_order.push_back("SELECTEDloci");
 		parameters_numbers.push_back(1);
 	}
 
+	if(type_of_profile.empty()){
+		type_of_profile = "none";
+	}
+
+	if(type_of_trace.empty()){
+		type_of_trace = "none";
+	}
+
+	if(type_of_pool.empty()){
+		type_of_pool = "individuals";
+	}
+
+	if(threads.empty()){
+		threads.push_back(1);
+		parameters_in_order.push_back("THREADS");
+		parameters_numbers.push_back(1);
+	}
+
 	if(beta.empty()){
 		std::cerr << "Assuming no epistatic interaction (BETA = 1).\n";
 		beta.push_back(1);
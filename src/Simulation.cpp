@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <math.h>
 #include <cmath>
+#include <chrono>
 
 #include "../include/SimulationSetting.h"
 #include "../include/Simulation.h"
@@ -59,9 +60,7 @@ int Simulation::simulate(){
 		}
 	}
 
-	clock_t t_total1, t_total2;
-	t_total1 = clock();
-	clock_t t1, t2;
+	std::chrono::steady_clock::time_point total_start = std::chrono::steady_clock::now();
 
 	int order = 0, check = 0;
 	// variable modulo contain a modulo for generations to produce an output (check line 93)
@@ -77,13 +76,18 @@ int Simulation::simulate(){
 	world.restart();
 
 	for(int i=0; i < generations;i++){
-		t1=clock();
 		// std::cerr << "Migration: " << i + 1 << std::endl;
+		profiler.start(MIGRATION);
 		world.migration();
+		profiler.stop(MIGRATION);
 		// std::cerr << "Breeding: " << i + 1 << std::endl;
+		profiler.start(BREEDING);
 		world.globalBreeding();
-		t2=clock();
-		std::cerr << "Generation: " << i + 1 << " done in " << ((float)t2 - (float)t1) / CLOCKS_PER_SEC << "\n";
+		profiler.stop(BREEDING);
+		if(profile_type != "none"){ // counting of junctions and memory is a walk through the whole world
+			profiler.countBred(world.getNumberOfIndividuals(), world.getMeanNumberOfJunctions() * world.getNumberOfIndividuals());
+			profiler.countMemory(world.getMemoryUsage());
+		}
 		if((((i - delay) % modulo)+1) == modulo and (i - delay < generations - modulo or i+1 == generations)){
 			order++;
 			check = saveWorld(order, save_pos);
@@ -92,6 +96,11 @@ int Simulation::simulate(){
 				return 1;
 			}
 		}
+		// the final save (below) belongs to the last generation
+		if(i + 1 < generations){
+			profiler.endGeneration();
+			std::cerr << "Generation: " << i + 1 << " done in " << profiler.getLastGenerationTime() << "\n";
+		}
 	}
 
 // make the final save after simulation only if it was not done yet (in cases when number of generations divided by number of saves are not giving intiger)
@@ -103,12 +112,28 @@ int Simulation::simulate(){
 			return 1;
 		}
 	}
+	if(generations > 0){
+		profiler.endGeneration();
+		std::cerr << "Generation: " << generations << " done in " << profiler.getLastGenerationTime() << "\n";
+	}
 
-	t_total2 = clock();
-	std::cerr << "Total time of simulation: " << ((float)t_total2 - (float)t_total1) / CLOCKS_PER_SEC << std::endl;
+	std::cerr << "Total time of simulation: "
+	<< std::chrono::duration<double>(std::chrono::steady_clock::now() - total_start).count() << std::endl;
 	world.clear();
 
-	return 0;
+	if(tracer){
+		std::cerr << "Saving trace to: " << trace_name << std::endl;
+		check = tracer->save(trace_name);
+	}
+	if(profile_type != "none"){
+		std::cerr << "Saving profile to: " << profile_name << std::endl;
+		check += profiler.save(profile_name, profile_type);
+	}
+	return check;
+}
+
+PhaseTimes Simulation::getPhaseTimes() const{
+	return profiler.getPhaseTimes();
 }
 
 void Simulation::setWorld(SimulationSetting& simulation_setting){
@@ -118,19 +143,43 @@ void Simulation::setWorld(SimulationSetting& simulation_setting){
 	generations = simulation_setting.generations;
 	file_name = simulation_setting.file_to_save;
 	file_type = simulation_setting.type_of_save;
+
+	// profile and trace are named after output of the simulation (unnamed simulations are prefixed by "conjunction")
+	std::string base_name = file_name;
+	if(base_name.empty() or base_name[0] == '_' or base_name[0] == '.'){
+		base_name = "conjunction" + base_name;
+	}
+	profile_type = simulation_setting.type_of_profile;
+	if(profile_type != "json" and profile_type != "csv"){
+		profile_type = "none";
+	}
+	profile_name = base_name + "_profile." + profile_type;
+
+	if(simulation_setting.type_of_trace == "chrome"){
+		trace_name = base_name + "_trace.json";
+		tracer.reset(new Tracer(simulation_setting.threads));
+		profiler.setTracer(tracer.get());
+		world.setTracer(tracer.get());
+	}
 }
 
 int Simulation::saveWorld(int order, int save_pos){
 	// always print summary to std out
 	if(file_type != "raspberrypi"){
+		profiler.start(STATISTICS);
 		world.summary(std::cout);
+		profiler.stop(STATISTICS);
 		if(saves >= 1 || file_type == "backtrace"){
 			std::cerr << "Saving output to: " << file_name << std::endl;
 		}
 	}
 
+	int check = 0;
+	profiler.start(OUTPUT);
 	if (file_type == "backtrace"){
-		return world.saveTheUniverse(file_type, file_name);
+		check = world.saveTheUniverse(file_type, file_name);
+		profiler.stop(OUTPUT);
+		return check;
 	}
 	// only if number of saves and name of outfile are specified
 	if(saves >= 1 and file_name[0] != '.' and file_name[0] != '_'){
@@ -140,7 +189,8 @@ int Simulation::saveWorld(int order, int save_pos){
 		} else {
 			file_name[save_pos] = '0' + char(order);
 		}
-		return world.saveTheUniverse(file_type, file_name);
+		check = world.saveTheUniverse(file_type, file_name);
 	}
-	return 0;
+	profiler.stop(OUTPUT);
+	return check;
 }
@@ -0,0 +1,97 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * recording timeline of the simulation in Chrome Trace Event format
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../include/Tracer.h"
+
+const int EVENTS_PER_THREAD = 4096; // reserved in advance, so recording rarely allocates
+
+Tracer::Tracer(int threads) :
+	origin{std::chrono::steady_clock::now()},
+	buffers(threads > 1 ? threads : 1)
+{
+	for(unsigned int i = 0; i < buffers.size(); i++){
+		buffers[i].events.reserve(EVENTS_PER_THREAD);
+	}
+}
+
+double Tracer::now() const{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Tracer::record(const char* name, const char* category, double begin, int deme, int x, int y){
+	buffers[threadId()].events.push_back(TraceEvent{name, category, begin, now() - begin, deme, x, y});
+}
+
+int Tracer::save(std::string filename) const{
+	std::ofstream ofile(filename);
+	if(!ofile.is_open()){
+		std::cerr << "Error: unable to open file for trace: " << filename << std::endl;
+		return 1;
+	}
+	ofile << std::fixed << std::setprecision(3); // microseconds with nanosecond resolution
+	ofile << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	for(unsigned int thread = 0; thread < buffers.size(); thread++){
+		ofile << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+		<< ", \"args\": {\"name\": \"thread " << thread << "\"}}";
+		for(unsigned int i = 0; i < buffers[thread].events.size(); i++){
+			ofile << ",\n";
+			streamEvent(ofile, buffers[thread].events[i], thread);
+		}
+		ofile << (thread + 1 < buffers.size() ? ",\n" : "\n");
+	}
+	ofile << "]}\n";
+	ofile.close();
+	return 0;
+}
+
+  // // // // //
+ // PRIVATE  //
+// // // // //
+
+// threads outside of a parallel region (or serial build) are recorded as thread 0
+int Tracer::threadId() const{
+#ifdef _OPENMP
+	int thread = omp_get_thread_num();
+	return thread < int(buffers.size()) ? thread : 0;
+#else
+	return 0;
+#endif
+}
+
+void Tracer::streamEvent(std::ostream& stream, const TraceEvent& event, int thread) const{
+	stream << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+	<< "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread
+	<< ", \"ts\": " << event.begin << ", \"dur\": " << event.duration;
+	if(event.deme >= 0){
+		stream << ", \"args\": {\"deme\": " << event.deme << ", \"x\": " << event.x << ", \"y\": " << event.y << "}";
+	}
+	stream << "}";
+}
@@ -0,0 +1,52 @@
+/*
+ * a unit of
+ * conjunction: simulator of secondary contact using Fisher's representation of genome admixture
+ * log-binned histograms of lengths of ancestry tracts
+Copyright (C) 2016  Kamil S. Jaron
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include "../include/TractHistogram.h"
+
+TractHistogram::TractHistogram(int loci) : counts(binOf(loci) + 1, 0) {
+}
+
+void TractHistogram::add(const std::vector<int>& sizes, int copies){
+	for(unsigned int i = 0; i < sizes.size(); i++){
+		counts[binOf(sizes[i])] += copies;
+	}
+}
+
+void TractHistogram::clear(){
+	counts.assign(counts.size(), 0);
+}
+
+int TractHistogram::getNumberOfBins() const{
+	return counts.size();
+}
+
+long long TractHistogram::getCount(int bin) const{
+	return counts[bin];
+}
+
+// the highest set bit of the length, tracts are at least one locus long
+int TractHistogram::binOf(int length){
+	if(length < 2){
+		return 0;
+	}
+	return 31 - __builtin_clz(length);
+}
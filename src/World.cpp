@@ -22,6 +22,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <math.h>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <utility>
 #include <unistd.h>
 
 #include "../include/RandomGenerators.h"
@@ -30,6 +32,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../include/Deme.h"
 #include "../include/World.h"
 
+const int ZERO_D_CHUNK = 1024; // individuals of 0D pool bred by one task (with own generator)
+const int JUNCTION_DENSITY_BINS = 100; // bins of positions of junctions of longer chromosomes
+
 World::World(const SimulationSetting& simulationSetting) :
 	context{simulationSetting.seed},
 	// USER
@@ -52,13 +57,23 @@ World::World(const SimulationSetting& simulationSetting) :
 	selection{simulationSetting.selection},
 	beta{simulationSetting.beta},
 	lambda{simulationSetting.lambda},
+	selected_loci{SelectedLoci::layout(simulationSetting.chromosomes, simulationSetting.loci, number_of_selected_loci,
+		simulationSetting.selected_positions)},
+	recombination_maps{RecombinationMap::load(simulationSetting.recombination_map, simulationSetting.chromosomes, simulationSetting.loci)},
 	// INTERNAL
+	threads{simulationSetting.threads > 1 ? simulationSetting.threads : 1},
+	weighted_pool{simulationSetting.type_of_pool == "weighted"},
+	record_pedigree{simulationSetting.type_of_save == "backtrace"},
+	tracer{nullptr},
 	edges_per_deme{simulationSetting.edges_per_deme},
 	index_last_left{-1},
 	index_next_left{-1},
 	index_last_right{-1},
-	index_next_right{-1}
-{}
+	index_next_right{-1},
+	zeroD_statistics{0, 0, 0, 0, 0}
+{
+	std::cerr << "The SEED for random numbers is set to: " << simulationSetting.seed << std::endl;
+}
 
 void World::basicUnitCreator(char type, char init){
 	int max_index = world.size();
@@ -80,14 +95,14 @@ void World::basicUnitCreator(char type, char init){
 				} else {
 					new_indexes.push_back(index_next_right);
 				}
-				world[0] = new Deme(context, 0,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, x_coordinate, 0);
+				world[0] = new Deme(context, 0,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, x_coordinate, 0);
 				break;
 			case 'l':
 				new_indexes.clear();
 				new_indexes.push_back(max_index + 2);
 				new_indexes.push_back(index_last_left);
 				x_coordinate = world[index_last_left]->getX() - 1;
-				world[index_next_left] = new Deme(context, index_next_left,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, x_coordinate, 0);
+				world[index_next_left] = new Deme(context, index_next_left,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, x_coordinate, 0);
 				index_last_left = index_next_left;
 				index_next_left = max_index + 2;
 				break;
@@ -119,7 +134,7 @@ void World::basicUnitCreator(char type, char init){
 					}
 				}
 				x_coordinate = world[index_last_right]->getX() + 1;
-				world[index_next_right] = new Deme(context, index_next_right,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, x_coordinate, 0);
+				world[index_next_right] = new Deme(context, index_next_right,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, x_coordinate, 0);
 				index_last_right = index_next_right;
 				index_next_right = max_index + 2;
 				break;
@@ -141,7 +156,7 @@ void World::basicUnitCreator(char type, char init){
 				new_indexes.push_back(i + number_of_demes_u_d * 2);
 				new_indexes.push_back(upperBorder(i,max_index));
 				new_indexes.push_back(lowerBorder(i,max_index));
-				world[i] = new Deme(context, i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, 0, i);
+				world[i] = new Deme(context, i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, 0, i);
 			}
 			break;
 		case 'l':
@@ -154,7 +169,7 @@ void World::basicUnitCreator(char type, char init){
 				new_indexes.push_back(index_last_left + i);
 				new_indexes.push_back(upperBorder(index + i,index));
 				new_indexes.push_back(lowerBorder(index + i,index));
-				world[index + i] = new Deme(context, index + i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, x_coordinate, i);
+				world[index + i] = new Deme(context, index + i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, x_coordinate, i);
 			}
 			index_last_left = index;
 			break;
@@ -168,7 +183,7 @@ void World::basicUnitCreator(char type, char init){
 				new_indexes.push_back(sideBorder(index + i,index_next_right + i));
 				new_indexes.push_back(upperBorder(index + i,index));
 				new_indexes.push_back(lowerBorder(index + i,index));
-				world[index + i] = new Deme(context, index + i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, number_of_selected_loci, lambda, x_coordinate, i);
+				world[index + i] = new Deme(context, index + i,new_indexes,init, deme_size, selection, beta, number_of_chromosomes, number_of_loci, selected_loci, lambda, recombination_maps, record_pedigree, x_coordinate, i);
 			}
 			index_last_right = index;
 			break;
@@ -212,12 +227,17 @@ void World::worldSlave(){
 int World::migration(){
 //	const int demesize = deme_size;
 	if(dimension == 0){
-//		std::cerr << "Premigration Population size: " << zeroD_immigrant_pool.size() << std::endl;
-		zeroD_immigrant_pool.reserve(zeroD_immigrant_pool.size() + deme_size);
-		for(int i = 0; i < deme_size;i++){
-			zeroD_immigrant_pool.push_back(Imigrant(context, number_of_chromosomes, number_of_loci, lambda));
+//		std::cerr << "Premigration Population size: " << zeroD_pool.size() << std::endl;
+		Imigrant migrant(context, number_of_chromosomes, number_of_loci, lambda,
+				recombination_maps.empty() ? nullptr : &recombination_maps);
+		SelectionModel selection_model(selection, beta);
+		// weighted pool stores all migrants once
+		int entries = weighted_pool ? 1 : deme_size;
+		for(int i = 0; i < entries;i++){
+			zeroD_pool.push(migrant, weighted_pool ? deme_size : 1);
+			countImigrant(zeroD_pool, zeroD_pool.size() - 1, zeroD_statistics, selection_model);
 		}
-//		std::cerr << "Postmigration Population size: " << zeroD_immigrant_pool.size() << std::endl;
+//		std::cerr << "Postmigration Population size: " << zeroD_pool.size() << std::endl;
 		return 0;
 	}
 	if(world.empty()){
@@ -255,13 +275,13 @@ int World::migration(){
 		if(buff->first >= index_last_left_fix and buff->first < index_last_left_fix + number_of_demes_u_d){
 			cartesian_x = world[index_last_left_fix]->getX() - 1;
 			for(int k=0;k < MigInd; k++){
-				ImmigranBuffer[buff->first].push_back(Individual(&context, 'A', number_of_chromosomes, number_of_loci, lambda, number_of_selected_loci, std::tuple<int, int, int>(cartesian_x, cartesian_y, k)));
+				ImmigranBuffer[buff->first].push_back(createEdgeIndividual('A', cartesian_x, cartesian_y, k));
 			}
 		}
 		if(buff->first >= index_last_right_fix and buff->first < index_last_right_fix + number_of_demes_u_d){
 			cartesian_x = world[index_last_right_fix]->getX() + 1;
 			for(int k=0;k < MigInd; k++){
-				ImmigranBuffer[buff->first].push_back(Individual(&context, 'B', number_of_chromosomes, number_of_loci, lambda, number_of_selected_loci, std::tuple<int, int, int>(cartesian_x, cartesian_y,  k)));
+				ImmigranBuffer[buff->first].push_back(createEdgeIndividual('B', cartesian_x, cartesian_y, k));
 			}
 		}
 		if(index_next_left <= buff->first and buff->first < index_next_left + number_of_demes_u_d){
@@ -276,87 +296,144 @@ int World::migration(){
 			}
 			basicUnitCreator('r', 'B');
 		}
+		double begin = tracer != nullptr ? tracer->now() : 0;
 		world[buff->first]->integrateMigrantVector(buff->second);
+		if(tracer != nullptr){
+			Deme *deme = world[buff->first];
+			tracer->record("Deme::integrateMigrantVector", "migration", begin, deme->getDemeIndex(), deme->getX(), deme->getY());
+		}
 	}
 	return 0;
 }
 
 void World::globalBreeding(){
 	if(dimension == 0){
-	SelectionModel selection_model;
-	selection_model.setSelectionPressure(selection);
-	selection_model.setBeta(beta);
-
-	double material = 0;
-	for(unsigned int i = 0;i < zeroD_immigrant_pool.size();i++){
-		material += zeroD_immigrant_pool[i].getBprop();
-	}
-		// std::cout << "Starting population size: " << zeroD_immigrant_pool.size() << std::endl;
-		// std::cout << "Amount of material: " << material << std::endl;
-
-		std::vector<Imigrant> new_generation;
-		std::vector<Chromosome> gamete;
-
-		new_generation.reserve(zeroD_immigrant_pool.size());
-		gamete.reserve(number_of_chromosomes);
-		double fitness = 0, hybrid_index = 0;
-		int num_of_desc = 0;
-
-		for(unsigned int index = 0; index < zeroD_immigrant_pool.size(); index++){
-			hybrid_index = zeroD_immigrant_pool[index].getBprop() / 2;
-			fitness = selection_model.getFitness(hybrid_index);
-//			every7 individual has 2 attempts to mate
-			for(int attempt = 0; attempt < 2; attempt++){
-				num_of_desc = context.random.poisson(fitness);
-				for(int i=0;i<num_of_desc;i++){
-					zeroD_immigrant_pool[index].makeGamete(gamete);
-					if(isGameteA(gamete)){
-						continue;
+		// std::cout << "Starting population size: " << zeroD_pool.size() << std::endl;
+		int pool_size = zeroD_pool.size();
+		int number_of_chunks = (pool_size + ZERO_D_CHUNK - 1) / ZERO_D_CHUNK;
+
+		// every chunk of the pool has own generator and own part of the offspring buffer, parts are
+		// merged in order of chunks, therefore the result does not depend on the number of threads
+		std::vector<int> seeds(number_of_chunks);
+		for(int chunk = 0; chunk < number_of_chunks; chunk++){
+			seeds[chunk] = context.random.seed();
+		}
+		if(int(zeroD_offspring.size()) < number_of_chunks){
+			zeroD_offspring.resize(number_of_chunks);
+		}
+		// statistics of the offspring are computed while they are bred
+		std::vector<PoolStatistics> statistics(number_of_chunks, PoolStatistics{0, 0, 0, 0, 0});
+		// probability that a gamete is an inherited copy (no chiasma and parental start in all chromosomes)
+		double copy_probability = pow(exp(-lambda) / 2, number_of_chromosomes);
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+		for(int chunk = 0; chunk < number_of_chunks; chunk++){
+			RandomGenerator random(seeds[chunk]);
+			SelectionModel selection_model(selection, beta);
+			ImigrantPool& offspring = zeroD_offspring[chunk];
+			std::vector<Recombination> recombination;
+			double fitness = 0;
+			int num_of_desc = 0, copies = 0;
+			int last_index = std::min(pool_size, (chunk + 1) * ZERO_D_CHUNK);
+			offspring.clear();
+
+			for(int index = chunk * ZERO_D_CHUNK; index < last_index; index++){
+				const Imigrant& parent = zeroD_pool[index];
+				fitness = zeroD_pool.getFitness(index);
+				if(weighted_pool){
+					// all copies of imigrant have 2 attempts to mate, inherited copies are stored once
+					num_of_desc = random.poisson(2 * zeroD_pool.getCopies(index) * fitness);
+					copies = random.binomial(num_of_desc, copy_probability);
+					if(copies > 0){
+						offspring.push(parent, copies);
+						countImigrant(offspring, offspring.size() - 1, statistics[chunk], selection_model);
+					}
+					// the other gametes are drawn conditionally on not being a copy
+					for(int i = copies; i < num_of_desc; i++){
+						do {
+							parent.drawRecombination(recombination, random);
+						} while(parent.isCopy(recombination));
+						// pure 'A' gametes are rejected before they are written
+						if(!parent.carriesB(recombination)){
+							continue;
+						}
+						offspring.push(1).inherit(parent, recombination);
+						countImigrant(offspring, offspring.size() - 1, statistics[chunk], selection_model);
+					}
+					continue;
+				}
+//				every7 individual has 2 attempts to mate
+				for(int attempt = 0; attempt < 2; attempt++){
+					num_of_desc = random.poisson(fitness);
+					for(int i=0;i<num_of_desc;i++){
+						parent.drawRecombination(recombination, random);
+						if(!parent.carriesB(recombination)){
+							continue;
+						}
+						offspring.push(1).inherit(parent, recombination);
+						countImigrant(offspring, offspring.size() - 1, statistics[chunk], selection_model);
 					}
-					new_generation.push_back( Imigrant(context, gamete, lambda) );
 				}
 			}
 		}
-		zeroD_immigrant_pool.clear(); // 1, this is incredibly stupid what I am doing here
-		zeroD_immigrant_pool.swap(new_generation); // 2, I should change pointers instead of copy-pasting
-		int pop_size = int(zeroD_immigrant_pool.size());
-		for(int i = 0;i < pop_size;i++){
-			material += zeroD_immigrant_pool[i].getBprop();
+
+		// imigrants of the offspring buffer are exchanged for the slots of parents, both buffers keep their storage
+		zeroD_pool.clear();
+		zeroD_statistics = PoolStatistics{0, 0, 0, 0, 0};
+		for(int chunk = 0; chunk < number_of_chunks; chunk++){
+			ImigrantPool& offspring = zeroD_offspring[chunk];
+			for(int i = 0; i < offspring.size(); i++){
+				// all pure B imigrants of weighted pool are merged to one
+				if(weighted_pool){
+					zeroD_pool.takeMerged(offspring, i);
+				} else {
+					zeroD_pool.take(offspring, i);
+				}
+			}
+			offspring.clear();
+			zeroD_statistics.individuals += statistics[chunk].individuals;
+			zeroD_statistics.material += statistics[chunk].material;
+			zeroD_statistics.b_blocks += statistics[chunk].b_blocks;
+			zeroD_statistics.fitness += statistics[chunk].fitness;
+			zeroD_statistics.junctions += statistics[chunk].junctions;
 		}
-		new_generation.clear(); // 3, in memory
 		return;
 	}
 
-	std::vector<int> indexes;
+	// demes are collected first, world map can not be accessed from parallel threads
+	std::vector<Deme*> demes;
+	demes.reserve(world.size());
 	for (std::map<int, Deme*>::const_iterator i=world.begin(); i!=world.end(); ++i){
-		indexes.push_back(i->first);
-	}
-
-	int index = 0;
-	int i_size = indexes.size();
-
-// 	#pragma omp parallel
-// 	{
-//
-// 		{
-// 		#ifdef _OPENMP
-// 		int tnum = omp_get_num_threads();
-// 		#else
-// 		int tnum = 1;
-// 		#endif
-//
-// 		std::cout << "Number of threads " << tnum << " "<< i_size << std::endl;
-// 		}
-//
-// 	#pragma omp parallel for
-		for(int i = 0; i < i_size; i++){
-			index = indexes[i];
-			world[index]->Breed();
-		}
-// 	}
+		demes.push_back(i->second);
+	}
+
+	// every deme has own generator of random numbers, therefore the result does not depend
+	// on the number of threads nor the order in which the demes are bred
+	int number_of_demes = demes.size();
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+	for(int i = 0; i < number_of_demes; i++){
+		double begin = tracer != nullptr ? tracer->now() : 0;
+		demes[i]->Breed();
+		if(tracer != nullptr){
+			tracer->record("Deme::Breed", "breeding", begin, demes[i]->getDemeIndex(), demes[i]->getX(), demes[i]->getY());
+		}
+	}
 	return;
 }
 
+// pure individuals migrating from the outside of the simulated world, born at x, y
+Individual World::createEdgeIndividual(char origin, int x, int y, int index) const{
+	Individual edge_individual(origin, number_of_chromosomes, number_of_loci);
+	if(record_pedigree){
+		edge_individual.setPedigree(std::tuple<int, int, int>(x, y, index), std::tuple<int, int, int>(), std::tuple<int, int, int>());
+	}
+	return edge_individual;
+}
+
 
   // // // // // // //
  // LOGICAL METHODS//
@@ -410,8 +487,17 @@ void World::listOfNumericalParameters(std::ostream& stream) const{
 	<< "# Lambda: " << lambda << std::endl
 	<< "# Beta: " << beta << std::endl
 	<< "# Loci: " << number_of_loci << std::endl;
-	if(number_of_selected_loci != number_of_loci){
-		stream << "# Selected loci : " << number_of_selected_loci << std::endl;
+	// a single count if all chromosomes select the same number of loci
+	bool same_counts = true;
+	for(int ch = 1; ch < number_of_chromosomes; ch++){
+		same_counts = same_counts and selected_loci[ch].size() == selected_loci[0].size();
+	}
+	if(!same_counts or selected_loci[0].size() != number_of_loci){
+		stream << "# Selected loci : " << selected_loci[0].size();
+		for(int ch = 1; ch < number_of_chromosomes and !same_counts; ch++){
+			stream << "," << selected_loci[ch].size();
+		}
+		stream << std::endl;
 	}
 	stream << "# Chromosomes: " << number_of_chromosomes << std::endl;
 	if(dimension == 0){
@@ -426,7 +512,7 @@ void World::listOfNumericalParameters(std::ostream& stream) const{
 void World::listOfDemes(){
 	std::cerr << "of dimension: " << dimension << std::endl;
 	if(dimension == 0){
-		std::cerr << "Population of imigrants has " << zeroD_immigrant_pool.size() << std::endl;
+		std::cerr << "Population of imigrants has " << getNumberOfIndividuals() << std::endl;
 	} else {
 		std::cerr << "World of size " << world.size() << std::endl;
 		std::cerr << "Number of demes up to down: " << number_of_demes_u_d << std::endl;
@@ -460,7 +546,7 @@ int World::summary(std::ostream& stream){
 		<< std::setw(12) << std::left << "Material"
 		<< std::setw(16) << std::left << "TotalBlocks"
 		<< std::setw(12) << std::left << "MeanFitness" << std::endl;
-		stream << std::setw(12) << std::left <<  zeroD_immigrant_pool.size()
+		stream << std::setw(12) << std::left <<  getNumberOfIndividuals()
 		<< std::setw(12) << std::left <<  getMaterial()
 		<< std::setw(16) << std::left <<  getTotalNumberOfBBlocks()
 		<< std::setw(12) << std::left <<  getMeanFitness() << std::endl;
@@ -501,13 +587,11 @@ int World::summary(std::ostream& stream){
 	return 0;
 }
 
+// 0D statistics are computed while imigrants enter the pool (migration and breeding)
 double World::getMaterial() const{
 	double material = 0;
 	if(dimension == 0){
-		int pop_size = zeroD_immigrant_pool.size();
-		for(int i = 0;i < pop_size;i++){
-			material += zeroD_immigrant_pool[i].getBprop();
-		}
+		material = zeroD_statistics.material;
 	} else {
 		std::cerr << "getMaterial is not implemented for " << dimension << "D\n";
 	}
@@ -517,9 +601,7 @@ double World::getMaterial() const{
 int World::getTotalNumberOfBBlocks(){
 	int blocks = 0;
 	if(dimension == 0){
-		for(unsigned int i = 0;i < zeroD_immigrant_pool.size();i++){
-			blocks += zeroD_immigrant_pool[i].getNumberOfBBlocks();
-		}
+		blocks = zeroD_statistics.b_blocks;
 	} else {
 		std::cerr << "getTotalJunctions is not implemented for " << dimension << "D\n";
 	}
@@ -527,18 +609,9 @@ int World::getTotalNumberOfBBlocks(){
 }
 
 double World::getMeanFitness() const{
-	double total_fitness = 0, hybrid_index = 0;
-	SelectionModel selection_model;
-	selection_model.setSelectionPressure(selection);
-	selection_model.setBeta(beta);
-
+	double total_fitness = 0;
 	if(dimension == 0){
-		int pop_size = zeroD_immigrant_pool.size();
-		for(int i = 0;i < pop_size;i++){
-			hybrid_index = zeroD_immigrant_pool[i].getBprop() / 2;
-			total_fitness += selection_model.getFitness(hybrid_index);
-		}
-		total_fitness = total_fitness / pop_size;
+		total_fitness = zeroD_statistics.fitness / zeroD_statistics.individuals;
 	} else {
 		std::cerr << "getMeanFitness is not implemented for " << dimension << "D\n";
 	}
@@ -584,6 +657,19 @@ int World::saveTheUniverse(std::string type, std::string filename){
 		return_value = saveBlocks(ofile);
 	}
 
+	// for 1D / 2D
+	if(type == "linkage"){
+		return_value = saveLinkage(ofile);
+	}
+
+	// for all dims
+	if(type == "tracts"){
+		return_value = saveTracts(ofile);
+	}
+	if(type == "junctionDensity"){
+		return_value = saveJunctionDensity(ofile);
+	}
+
 	ofile.close();
 	return return_value;
 }
@@ -595,12 +681,57 @@ void World::getLD(){
 	std::cout << std::endl;
 }
 
+// mean number of junctions per individual (per imigrant in 0D)
+double World::getMeanNumberOfJunctions(){
+	double junctions = 0;
+	if(dimension == 0){
+		junctions = zeroD_statistics.junctions;
+	} else {
+		for (std::map<int, Deme*>::const_iterator i=world.begin(); i!=world.end(); ++i){
+			junctions += i->second->getMeanNumberOfJunctions() * deme_size;
+		}
+	}
+	int individuals = getNumberOfIndividuals();
+	return individuals > 0 ? junctions / individuals : 0;
+}
+
+int World::getNumberOfIndividuals() const{
+	if(dimension == 0){
+		return zeroD_statistics.individuals;
+	}
+	return world.size() * deme_size;
+}
+
+// 0D pool is reported as one deme
+MemoryUsage World::getMemoryUsage() const{
+	MemoryUsage usage{0, 0, 0, 0};
+	if(dimension == 0){
+		zeroD_pool.addMemoryUsage(usage);
+		usage.individuals += (zeroD_offspring.capacity() - zeroD_offspring.size()) * sizeof(ImigrantPool);
+		for(unsigned int i = 0;i < zeroD_offspring.size();i++){
+			zeroD_offspring[i].addMemoryUsage(usage);
+		}
+		usage.largest_deme = usage.chromosomes + usage.chiasmata + usage.individuals;
+		usage.demes.push_back(DemeMemoryUsage{0, 0, 0, usage.chromosomes, usage.chiasmata, usage.individuals});
+		return usage;
+	}
+	for (std::map<int, Deme*>::const_iterator i=world.begin(); i!=world.end(); ++i){
+		i->second->addMemoryUsage(usage);
+	}
+	return usage;
+}
+
   // // // // // // // //
  // PARAMETER HANDLING//
 // // // // // // // //
+void World::setTracer(Tracer* world_tracer){
+	tracer = world_tracer;
+}
+
 void World::restart(){
 	if(dimension == 0){
-		zeroD_immigrant_pool.clear();
+		zeroD_pool.clear();
+		zeroD_statistics = PoolStatistics{0, 0, 0, 0, 0};
 	} else {
 		clear();
 		worldSlave();
@@ -611,7 +742,8 @@ void World::restart(){
 
 void World::clear(){
 	if(dimension == 0){
-		zeroD_immigrant_pool.clear();
+		zeroD_pool.clear();
+		zeroD_statistics = PoolStatistics{0, 0, 0, 0, 0};
 	} else {
 		for (std::map<int, Deme*>::const_iterator i=world.begin(); i!=world.end(); ++i){
 			delete i->second;
@@ -696,16 +828,6 @@ int World::sideBorder(int reflexive, int extending){
 	return -1;
 }
 
-bool World::isGameteA(std::vector<Chromosome>& gamete){
-	for(int i=0;i<number_of_chromosomes;i++){
-		if(gamete[i].isPureA()){
-			continue;
-		}
-		return 0;
-	}
-	return 1;
-}
-
 int World::saveLinesPerIndividual(std::ofstream& ofile, std::string type){
 	if(dimension == 0){
 		// TO DO
@@ -744,6 +866,15 @@ int World::saveLinesPerDeme(std::ostream& stream, std::string type){
 			if(type == "complete"){
 				world[deme_to_print]->streamHeterozygosity(stream);
 			}
+			if(type == "linkage"){
+				world[deme_to_print]->streamLinkage(stream);
+			}
+			if(type == "tracts"){
+				world[deme_to_print]->streamTracts(stream);
+			}
+			if(type == "junctionDensity"){
+				world[deme_to_print]->streamJunctionDensity(stream, std::min(number_of_loci, JUNCTION_DENSITY_BINS));
+			}
 
 		}
 		next_column = world[comlumn_to_print]->getNeigbours()[1];
@@ -765,7 +896,7 @@ int World::saveLinesPerDeme(std::ostream& stream, std::string type){
 		}
 		stream << "] SL=[";
 		for(int ch = 0; ch < number_of_chromosomes; ch++){
-			stream << number_of_selected_loci;
+			stream << selected_loci[ch].size();
 			if ( (ch + 1) < number_of_chromosomes) {
 				stream << ",";
 			}
@@ -837,12 +968,111 @@ int World::saveBacktrace(std::ofstream& ofile){
 	return 0;
 }
 
+// a matrix of loci per deme and chromosome, D of the loci above the diagonal, r^2 below it and p(1 - p) on it
+int World::saveLinkage(std::ofstream& ofile){
+	if(dimension == 0){
+		throw std::runtime_error("Linkage output is not implemented for 0D simulations, imigrants of the pool do not form demes.");
+	}
+	ofile << "Dx,Dy\tC\tl";
+	for(int l = 0; l < number_of_loci; l++){
+		ofile << "\tl" << l + 1;
+	}
+	ofile << std::endl;
+	saveLinesPerDeme(ofile, "linkage");
+	ofile.close();
+	return 0;
+}
+
+// histograms of A and B tracts per deme (a single one of the 0D pool), columns are the shortest tracts of bins
+int World::saveTracts(std::ofstream& ofile){
+	ofile << "Dx,Dy\ttract";
+	for(int bin = 0; bin < TractHistogram(number_of_loci).getNumberOfBins(); bin++){
+		ofile << '\t' << (1 << bin);
+	}
+	ofile << std::endl;
+	if(dimension == 0){
+		streamTractsOf0DWorld(ofile);
+	} else {
+		saveLinesPerDeme(ofile, "tracts");
+	}
+	ofile.close();
+	return 0;
+}
+
+// junctions per deme and chromosome in bins of positions (a bin per locus if loci fit the bins),
+// columns are the first positions of bins
+int World::saveJunctionDensity(std::ofstream& ofile){
+	int bins = std::min(number_of_loci, JUNCTION_DENSITY_BINS);
+	ofile << "Dx,Dy\tC";
+	for(int bin = 0; bin < bins; bin++){
+		ofile << '\t' << ((long long)bin * number_of_loci + bins - 1) / bins;
+	}
+	ofile << std::endl;
+	if(dimension == 0){
+		streamJunctionDensityOf0DWorld(ofile);
+	} else {
+		saveLinesPerDeme(ofile, "junctionDensity");
+	}
+	ofile.close();
+	return 0;
+}
+
+// fitness of the imigrant is stored in the pool, so it is not recomputed for breeding
+void World::countImigrant(ImigrantPool& pool, int index, PoolStatistics& statistics, SelectionModel& selection_model) const{
+	Imigrant& imigrant = pool[index];
+	int copies = pool.getCopies(index);
+	double prop = imigrant.getBprop();
+	double fitness = selection_model.getFitness(prop / 2);
+	pool.setFitness(index, fitness);
+	statistics.individuals += copies;
+	statistics.material += prop * copies;
+	statistics.b_blocks += imigrant.getNumberOfBBlocks() * copies;
+	statistics.fitness += fitness * copies;
+	statistics.junctions += imigrant.getNumberOfJunctions() * copies;
+}
+
+// every imigrant is counted as many times as its copies
+void World::streamTractsOf0DWorld(std::ostream& stream){
+	TractHistogram a_tracts(number_of_loci), b_tracts(number_of_loci);
+	std::vector<int> sizes;
+	for(int index = 0; index < zeroD_pool.size(); index++){
+		zeroD_pool[index].getSizesOfABlocks(sizes);
+		a_tracts.add(sizes, zeroD_pool.getCopies(index));
+		zeroD_pool[index].getSizesOfBBlocks(sizes);
+		b_tracts.add(sizes, zeroD_pool.getCopies(index));
+	}
+	for(const TractHistogram* tracts : {&a_tracts, &b_tracts}){
+		stream << "0D\t" << (tracts == &a_tracts ? 'A' : 'B');
+		for(int bin = 0; bin < tracts->getNumberOfBins(); bin++){
+			stream << '\t' << tracts->getCount(bin);
+		}
+		stream << std::endl;
+	}
+}
+
+void World::streamJunctionDensityOf0DWorld(std::ostream& stream){
+	int bins = std::min(number_of_loci, JUNCTION_DENSITY_BINS);
+	std::vector<long long> counts(number_of_chromosomes * bins, 0);
+	for(int index = 0; index < zeroD_pool.size(); index++){
+		zeroD_pool[index].addJunctionPositions(counts, bins, zeroD_pool.getCopies(index));
+	}
+	for(int ch = 0; ch < number_of_chromosomes; ch++){
+		stream << "0D\t" << ch + 1;
+		for(int bin = 0; bin < bins; bin++){
+			stream << '\t' << counts[ch * bins + bin];
+		}
+		stream << std::endl;
+	}
+}
+
 void World::streamBlockSizesOf0DWorld(std::ostream& stream){
 	std::vector<int> blockSizes;
-	for(unsigned int index = 0; index < zeroD_immigrant_pool.size(); index++){
-		zeroD_immigrant_pool[index].getSizesOfBBlocks(blockSizes);
-		for(unsigned int i = 0;i < blockSizes.size(); i++){
-			stream << std::fixed << blockSizes[i] / double(number_of_loci) << std::endl;
+	for(int index = 0; index < zeroD_pool.size(); index++){
+		zeroD_pool[index].getSizesOfBBlocks(blockSizes);
+		for(int copy = 0; copy < zeroD_pool.getCopies(index); copy++){
+			for(unsigned int i = 0;i < blockSizes.size(); i++){
+				stream << std::fixed << blockSizes[i] / double(number_of_loci) << std::endl;
+			}
 		}
 		blockSizes.clear();
 	}
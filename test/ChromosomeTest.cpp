@@ -5,6 +5,15 @@
  *      Author: kjaron
  */
 
+// recombinant of a chromosome and pure A chromosome with the given number of chiasmata
+Chromosome makeRecombinantOf(const Chromosome& parent, int chiasmata, Context& context){
+	Chromosome recombinant;
+	std::vector<int> recombination;
+	parent.drawRecombination(recombination, chiasmata, context.random);
+	parent.writeRecombinant(recombinant, recombination, context.random.tossAcoin());
+	return recombinant;
+}
+
 int testChromosome(){
 	Chromosome ch1('A',50);
 	Chromosome ch2('B',50);
@@ -49,6 +58,101 @@ int testChromosome(){
 		}
 	}
 
+	// sorted positions (drawn with replacement) cover all positions uniformly
+	std::vector<int> hits(21, 0);
+	int sample[30];
+	for(int i = 0; i < 20000; i++){
+		int count = context.random.sampleRecombPositions(sample, i % 12, 21);
+		if(count != i % 12){
+			std::cerr << "ERROR: sampleRecombPositions returned " << count << " positions instead of " << i % 12 << std::endl;
+			return 1;
+		}
+		for(int j = 0; j < count; j++){
+			if(sample[j] < 1 or sample[j] > 20 or (j > 0 and sample[j - 1] > sample[j])){
+				std::cerr << "ERROR: sampleRecombPositions generated positions that are not sorted" << std::endl;
+				return 1;
+			}
+			hits[sample[j]]++;
+		}
+	}
+	for(int position = 1; position <= 20; position++){
+		// 110000 positions over 20 loci, 5500 per locus
+		if(hits[position] < 5000 or hits[position] > 6000){
+			std::cerr << "ERROR: sampleRecombPositions hits position " << position << " " << hits[position] << " times" << std::endl;
+			return 1;
+		}
+	}
+	// chiasmata may share a position, more chiasmata than positions are drawn
+	if(context.random.sampleRecombPositions(sample, 30, 21) != 30 or sample[29] > 20){
+		std::cerr << "ERROR: sampleRecombPositions does not draw all chiasmata asked" << std::endl;
+		return 1;
+	}
+
+	// a flat map places chiasmata as the uniform recombination does
+	RecombinationMap flat_map({1}, {1}, 21);
+	double rolls[30];
+	int flat_sample[30];
+	for(int i = 0; i < 1000; i++){
+		int count = i % 30;
+		for(int j = 0; j < count; j++){
+			rolls[j] = context.random.uniform();
+		}
+		context.random.sampleRecombPositions(sample, rolls, count, 21);
+		context.random.sampleRecombPositions(flat_sample, rolls, count, flat_map);
+		for(int j = 0; j < count; j++){
+			if(sample[j] != flat_sample[j]){
+				std::cerr << "ERROR: chiasmata of a flat recombination map differ from uniform recombination" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	// chiasmata of the second chromosome of the map fall on positions 10 and 11 with probability 90 / 99
+	// and never after position 11
+	std::vector<RecombinationMap> maps = RecombinationMap::load("./test/data/recombination_map", 2, 21);
+	if(maps.size() != 2 or maps[0].getNumberOfPositions() != 20 or maps[1].getNumberOfPositions() != 11){
+		std::cerr << "ERROR: recombination map ./test/data/recombination_map was misinterpreted" << std::endl;
+		return 1;
+	}
+	int hotspot = 0;
+	for(int i = 0; i < 10000; i++){
+		int count = context.random.sampleRecombPositions(sample, nullptr, 1 + i % 3, maps[1]);
+		for(int j = 0; j < count; j++){
+			if(sample[j] < 1 or sample[j] > 11 or (j > 0 and sample[j - 1] > sample[j])){
+				std::cerr << "ERROR: chiasmata of a recombination map are not sorted or out of the map" << std::endl;
+				return 1;
+			}
+		}
+		if(count == 1 and sample[0] >= 10){
+			hotspot++;
+		}
+	}
+	// 3334 single chiasmata, 3031 expected in the hotspot
+	if(hotspot < 2900 or hotspot > 3150){
+		std::cerr << "ERROR: " << hotspot << " single chiasmata of 3334 fall in the hotspot of recombination map" << std::endl;
+		return 1;
+	}
+	// chiasmata of a map may share a position, more chiasmata than positions of the map are drawn
+	if(context.random.sampleRecombPositions(sample, nullptr, 15, maps[1]) != 15 or sample[14] > 11){
+		std::cerr << "ERROR: sampleRecombPositions does not draw all chiasmata asked from a map" << std::endl;
+		return 1;
+	}
+
+	// a sharp hotspot at a single position takes nearly all chiasmata, many of them on the same position
+	RecombinationMap sharp_map(std::vector<int>{1, 500, 501}, std::vector<double>{1, 1000000, 1}, 1000);
+	int at_hotspot = 0, total = 0;
+	for(int i = 0; i < 2000; i++){
+		int count = context.random.sampleRecombPositions(sample, nullptr, 1 + context.random.poisson(4.5), sharp_map);
+		for(int j = 0; j < count; j++){
+			at_hotspot += (sample[j] == 500);
+		}
+		total += count;
+	}
+	if(at_hotspot < 0.99 * total){
+		std::cerr << "ERROR: " << at_hotspot << " of " << total << " chiasmata fall in a single locus hotspot" << std::endl;
+		return 1;
+	}
+
 	Chromosome ch3('X',5);
 	ch3.setResolution(666);
 	if(ch3.getResolution() != 666){
@@ -69,7 +173,9 @@ int testChromosome(){
 		return 1;
 	}
 
-	ch2.makeRecombinant(ch3, 5, context);
+	// chiasmata drawn with replacement cancel out if they share a position, that is unlikely on a long chromosome
+	Chromosome long_b('B', 100000);
+	long_b.makeRecombinant(ch3, 5, context);
 
 	if(ch3.getNumberOfJunctions() < 4){
 		std::cerr << "WARNING: very unlike scenario in random generation of junctions" << std::endl;
@@ -98,6 +204,98 @@ int testChromosome(){
 		return 1;
 	}
 
+	// junctions at 2, 5 and 6 of 10 loci in 3 bins of positions
+	long long junction_counts[3] = {0, 0, 0};
+	ch4.addJunctionPositions(junction_counts, 3, 2);
+	if(junction_counts[0] != 2 or junction_counts[1] != 4 or junction_counts[2] != 0){
+		std::cerr << "ERROR in method counting junctions in bins of positions: addJunctionPositions" << std::endl;
+		return 1;
+	}
+
+	std::vector<int> recombination;
+	for(int i = 0; i < 200; i++){
+		int starts_by = context.random.tossAcoin();
+		ch4.drawRecombination(recombination, i % 4, context.random);
+		ch4.writeRecombinant(ch3, recombination, starts_by);
+		if(ch4.inheritsB(recombination, starts_by) == ch3.isPureA()){
+			std::cerr << "ERROR: inheritsB does not match the written recombinant" << std::endl;
+			return 1;
+		}
+	}
+
+	// ranks of listed selected loci spanning several words
+	SelectedLoci listed(200, std::vector<int>{0, 63, 64, 130, 199});
+	if(listed.size() != 5 or listed.rank(0) != 0 or listed.rank(1) != 1 or listed.rank(64) != 2 or
+	   listed.rank(65) != 3 or listed.rank(131) != 4 or listed.rank(199) != 4 or listed.rank(200) != 5){
+		std::cerr << "ERROR: ranks of selected loci 0, 63, 64, 130 and 199 of 200 loci are wrong" << std::endl;
+		return 1;
+	}
+
+	// every locus of a recombinant comes from the parent given by parity of chiasmata up to the locus,
+	// small chromosomes make chiasmata on junctions common
+	// selected loci 0, 3, 6 and 9 packed by recombination match the junctions of the recombinant,
+	// as well as selected loci counted on its junctions
+	Chromosome home('A', 12);
+	SelectedLoci selected(10, 4);
+	for(int i = 0; i < 500; i++){
+		Chromosome parent1 = makeRecombinantOf(ch4, 3, context);
+		Chromosome parent2 = makeRecombinantOf(ch4, 5, context);
+		parent1.packSelected(selected);
+		parent2.packSelected(selected);
+		int starts_by = context.random.tossAcoin();
+		ch4.drawRecombination(recombination, 1 + i % 6, context.random);
+		Chromosome::writeRecombinant(ch3, parent1, parent2, recombination.data(), recombination.size(), starts_by, &selected);
+		int selected_b = (ch3.read(0) == 'B') + (ch3.read(3) == 'B') + (ch3.read(6) == 'B') + (ch3.read(9) == 'B');
+		Chromosome unpacked(Junctions(ch3.begin(), ch3.end()), 10);
+		if(!ch3.isPacked() or ch3.countSelectedB(selected) != selected_b or unpacked.countSelectedB(selected) != selected_b){
+			std::cerr << "ERROR: packed selected loci of recombinant do not match its junctions" << std::endl;
+			return 1;
+		}
+		parent2.writeRecombinant(ch1, recombination, starts_by);
+		for(int locus = 0; locus < 10; locus++){
+			int source = (starts_by + std::upper_bound(recombination.begin(), recombination.end(), locus) - recombination.begin()) % 2;
+			if(ch3.read(locus) != (source == 0 ? parent1 : parent2).read(locus) or
+			   ch1.read(locus) != (source == 0 ? home : parent2).read(locus)){
+				std::cerr << "ERROR: recombinant differs from its parents at locus " << locus << std::endl;
+				return 1;
+			}
+		}
+		for(Chromosome* recombinant : {&ch3, &ch1}){
+			for(Junctions::iterator pos = recombinant->begin(); pos + 1 != recombinant->end(); ++pos){
+				if(pos->second == (pos + 1)->second){
+					std::cerr << "ERROR: recombinant contains a junction that does not change the material" << std::endl;
+					return 1;
+				}
+			}
+		}
+	}
+
+	// chiasmata of a hotspot map on the same position cancel out in pairs (lambda 4.5)
+	RecombinationMap hotspot10(std::vector<int>{1, 5, 6}, std::vector<double>{1, 1000000, 1}, 10);
+	for(int i = 0; i < 500; i++){
+		Chromosome parent1 = makeRecombinantOf(ch4, 3, context);
+		Chromosome parent2 = makeRecombinantOf(ch4, 5, context);
+		parent1.packSelected(selected);
+		parent2.packSelected(selected);
+		int starts_by = context.random.tossAcoin();
+		ch4.drawRecombination(recombination, context.random.poisson(4.5), context.random, &hotspot10);
+		Chromosome::writeRecombinant(ch3, parent1, parent2, recombination.data(), recombination.size(), starts_by, &selected);
+		parent2.writeRecombinant(ch1, recombination, starts_by);
+		for(int locus = 0; locus < 10; locus++){
+			int source = (starts_by + std::upper_bound(recombination.begin(), recombination.end(), locus) - recombination.begin()) % 2;
+			if(ch3.read(locus) != (source == 0 ? parent1 : parent2).read(locus) or
+			   ch1.read(locus) != (source == 0 ? home : parent2).read(locus)){
+				std::cerr << "ERROR: recombinant with chiasmata on the same position differs from its parents at locus " << locus << std::endl;
+				return 1;
+			}
+		}
+		int selected_b = (ch3.read(0) == 'B') + (ch3.read(3) == 'B') + (ch3.read(6) == 'B') + (ch3.read(9) == 'B');
+		if(ch3.countSelectedB(selected) != selected_b or parent2.inheritsB(recombination, starts_by) == ch1.isPureA()){
+			std::cerr << "ERROR: chiasmata on the same position are not cancelled by packing or by inheritsB" << std::endl;
+			return 1;
+		}
+	}
+
 /* Writing testing for plotting functions is not worth the energy spend on it, for verification,
 following code can be uncommented and used for manual testing */
 // 	ch1.makeRecombinant(ch3, 5);
@@ -8,7 +8,9 @@ int testDeme(){
 
 	Context context = createTestContext();
 //	index, neigb, init, size, selection, beta, in_ch, in_loc, in_lambda
-	Deme Hell(context, 0, neigb, 'C', 10000, 0.8, 1, 1, 16, 16, 10, 666, 666);
+	std::vector<SelectedLoci> selected_loci(1, SelectedLoci(16, 16));
+	std::vector<RecombinationMap> recombination_maps; // uniform recombination
+	Deme Hell(context, 0, neigb, 'C', 10000, 0.8, 1, 1, 16, selected_loci, 10, recombination_maps, false, 666, 666);
 
 //	std::cout << "*****S*****" << std::endl;
 //	Hell.streamSummary(cout);
@@ -51,6 +53,60 @@ int testDeme(){
 		std::cerr << "Warnig: Selection has unexpected behavior" << std::endl;
 	}
 
+	// B frequencies of loci follow the offspring and the migrants replacing residents
+	std::vector<Individual> migrants(100, Individual('B', 1, 16));
+	Hell.integrateMigrantVector(migrants);
+	std::vector<double> ps;
+	Hell.getps(ps, 0);
+	double mean_p = 0;
+	for(unsigned int locus = 0; locus < ps.size(); locus++){
+		mean_p += ps[locus] / ps.size();
+	}
+	if(ps.size() != 16 or std::abs(mean_p - Hell.getMeanBproportion()) > 1e-9){
+		std::cerr << "ERROR: mean B frequency of loci " << mean_p << " differs from mean B proportion "
+			<< Hell.getMeanBproportion() << std::endl;
+		return 1;
+	}
+
+	// halves of a founding deme are pure A and pure B, all loci are in complete linkage disequilibrium
+	Deme Eden(context, 1, neigb, 'C', 100, 0.8, 1, 1, 16, selected_loci, 10, recombination_maps, false, 0, 0);
+	std::vector<uint64_t> columns;
+	std::vector<double> D, r2;
+	int words = Eden.getHaplotypeColumns(columns, ps, 0);
+	for(int i = 0; i < 16; i++){
+		Eden.getPairwiseLD(D, r2, columns, ps, words, i);
+		for(unsigned int j = 0; j < D.size(); j++){
+			if(D.size() != 16 or D[j] != 0.25 or r2[j] != 1){
+				std::cerr << "ERROR: loci of a deme of pure A and pure B individuals have D " << D[j]
+					<< " and r^2 " << r2[j] << " (0.25 and 1 expected)" << std::endl;
+				return 1;
+			}
+		}
+	}
+	// every chromosome of the founding deme is a single tract of 16 loci, the last bin ([16, 32))
+	TractHistogram a_tracts(16), b_tracts(16);
+	Eden.addTracts(a_tracts, b_tracts);
+	if(a_tracts.getNumberOfBins() != 5 or a_tracts.getCount(4) != 100 or b_tracts.getCount(4) != 100 or b_tracts.getCount(3) != 0){
+		std::cerr << "ERROR: histograms of tracts of a deme of pure A and pure B individuals are wrong" << std::endl;
+		return 1;
+	}
+
+	// D of a locus with itself is p(1 - p), D is symmetric
+	std::vector<double> D_of_first, r2_of_first;
+	words = Hell.getHaplotypeColumns(columns, ps, 0);
+	Hell.getPairwiseLD(D_of_first, r2_of_first, columns, ps, words, 0);
+	for(unsigned int locus = 0; locus < ps.size(); locus++){
+		Hell.getPairwiseLD(D, r2, columns, ps, words, locus);
+		if(D[0] != D_of_first[locus] or std::abs(r2[0] - r2_of_first[locus]) > 1e-12){
+			std::cerr << "ERROR: linkage disequilibrium of loci 0 and " << locus << " is not symmetric" << std::endl;
+			return 1;
+		}
+		if(std::abs(D[locus] - ps[locus] * (1 - ps[locus])) > 1e-9){
+			std::cerr << "ERROR: D of locus " << locus << " with itself differs from p(1 - p)" << std::endl;
+			return 1;
+		}
+	}
+
 //	Hell.getFitnessVector(fv);
 //	for(unsigned int i = 0; i < fv.size(); i++){
 //		std::cout << " X " << fv[i] << " X ";
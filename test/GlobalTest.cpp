@@ -30,5 +30,31 @@ int testParameterLoading(){
 	}
 	delete sim;
 
+//	profile has a header, one line per generation and the line of totals
+	std::ifstream profile("HI_multi_locus_l1_c1_n1_profile.csv");
+	std::string line, last_line;
+	int lines = 0;
+	while(getline(profile, line)){
+		last_line = line;
+		lines++;
+	}
+	if(lines != one_sim_setting.generations + 2 or last_line.substr(0, 6) != "total,"){
+		std::cerr << " The profile of simulation has " << lines << " lines instead of "
+		<< one_sim_setting.generations + 2 << std::endl;
+		return 1;
+	}
+
+//	memory of demes has a header and at least one line per generation
+	std::ifstream demes_profile("HI_multi_locus_l1_c1_n1_profile_demes.csv");
+	lines = 0;
+	while(getline(demes_profile, line)){
+		lines++;
+	}
+	if(lines < one_sim_setting.generations + 1){
+		std::cerr << " The memory of demes of simulation has " << lines << " lines, expected at least "
+		<< one_sim_setting.generations + 1 << std::endl;
+		return 1;
+	}
+
 	return 0;
 }
@@ -1,13 +1,19 @@
 int testIndividual(){
 	Context context = createTestContext();
 	Individual Lili;
-	Individual Igor(&context, 'C', 3, 40, 2.3, 4, std::tuple<int, int, int>(-1, -1, -1));
-
+	Individual Igor('C', 3, 40);
+	double lambda = 2.3;
+	std::vector<SelectedLoci> selected_loci(3, SelectedLoci(40, 4));
+
+	// chiasmata of demes are drawn in batches from the tabulated distribution
+	PoissonTable chiasmata_table(lambda);
+	std::vector<int> chiasmata_counts(10000);
+	context.random.fillPoisson(chiasmata_counts.data(), 10000, chiasmata_table);
 	double sumCh = 0.0;
 	for(int i = 0; i < 10000; i++){
-		sumCh += context.random.poisson(Igor.getLambda());
+		sumCh += context.random.poisson(lambda) + chiasmata_counts[i];
 	}
-	sumCh = sumCh / 10000;
+	sumCh = sumCh / 20000;
 
 	if(sumCh > 2.5 or sumCh < 2.1){
 		std::cerr << "WARNING: unexpected behavior of generator of Chiasmas, " << std::endl;
@@ -21,16 +27,37 @@ int testIndividual(){
 	// will be equivalent to proportion of B in the sirt set
 	std::vector<Chromosome> gamete1;
 	std::vector<Chiasmata> chiasma1, chiasma2;
-	Igor.makeGamete(gamete1, chiasma1);
+	Igor.makeGamete(gamete1, &chiasma1, lambda, context.random);
 
 	std::vector<Chromosome> gamete2;
 	for(unsigned int i = 0; i < gamete1.size(); i++){
 		gamete2.push_back(Chromosome('A',gamete1[i].getResolution()));
 		chiasma2.push_back(Chiasmata());
 	}
-	Individual Stuart(&context, gamete1, chiasma1, gamete2, chiasma2, 1.6, Igor.getNumberOfSelectedLoci(), std::tuple<int, int, int>(-1, -1, -1));
+	Individual Stuart(gamete1, gamete2);
+	Stuart.setPedigree(std::tuple<int, int, int>(0, 0, 0), std::tuple<int, int, int>(1, 0, 0), std::tuple<int, int, int>(0, 1, 0), chiasma1, chiasma2);
+
+	std::vector<std::string> recombination_events;
+	Stuart.getChiasmata(recombination_events);
+	if(recombination_events[0] != chiasma1[0].collapse() or recombination_events[1] != "~"){
+		std::cerr << "Chiasmata recorded in pedigree do not match chiasmata of gametes" << std::endl;
+		return 1;
+	}
+
+	// chiasmata are kept sorted, also when they do not fit the inline buffer
+	Chiasmata recorded;
+	for(int i = 20; i > 0; i--){
+		recorded.add((i * 7) % 41);
+	}
+	Chiasmata copied(recorded);
+	for(int i = 1; i < copied.length(); i++){
+		if(copied.length() != 20 or copied.get(i - 1) > copied.get(i)){
+			std::cerr << "Chiasmata are not sorted: " << copied.collapse() << std::endl;
+			return 1;
+		}
+	}
 
-	if(Igor.getSelectedHybridIndex() != 0.5){
+	if(Igor.getSelectedHybridIndex(selected_loci) != 0.5){
 		std::cerr << "f1 hybrid has selected hybrid index != 0.5!" << std::endl;
 		return 1;
 	}
@@ -92,16 +119,25 @@ int testIndividual(){
 	ch1.write(13,'A'); ch2.write(14,'B');
 	gamete1.clear(); gamete1.push_back(ch1);
 	gamete2.clear(); gamete2.push_back(ch2);
-	Individual Anna(&context, gamete1, chiasma1, gamete2, chiasma2, 1.6, 4, std::tuple<int, int, int>(-1, -1, -1));
-	if(Anna.getSelectedHybridIndex() != 0.375){
+	Individual Anna(gamete1, gamete2);
+	if(Anna.getSelectedHybridIndex(selected_loci) != 0.375){
 		std::cerr << "Folowing individual :" << std::endl;
 		Anna.readGenotype();
-		std::cerr << "has unexpected selected hybrid index: " << Anna.getSelectedHybridIndex() << std::endl;
+		std::cerr << "has unexpected selected hybrid index: " << Anna.getSelectedHybridIndex(selected_loci) << std::endl;
 		std::cerr << "4 selected loci / chromosome of total 40 loci" << std::endl;
 		std::cerr << "means that selected loci have indices 0, 13, 26 and 39" << std::endl;
 		std::cerr << "therefore we expected 0.375 given the genotype..." << std::endl;
 		return 1;
 	}
 
+	// selected loci 5, 14 and 30 listed by the setting
+	Individual Bert(gamete1, gamete2);
+	std::vector<SelectedLoci> listed_loci(1, SelectedLoci(40, std::vector<int>{5, 14, 30}));
+	if(Bert.getSelectedHybridIndex(listed_loci) != 0.5){
+		std::cerr << "individual with selected loci 5, 14 and 30 has unexpected selected hybrid index: "
+			<< Bert.getSelectedHybridIndex(listed_loci) << ", 0.5 expected" << std::endl;
+		return 1;
+	}
+
 	return 0;
 }
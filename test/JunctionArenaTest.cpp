@@ -0,0 +1,86 @@
+// chromosome exposing the arena of its junctions
+class ArenaChromosome : public Chromosome {
+	public:
+		using Chromosome::Chromosome;
+		JunctionArena* getArena() const{
+			return chromosome.get_allocator().arena;
+		}
+};
+
+int testJunctionArena(){
+	// arenas are declared before the chromosomes, so the chromosomes are destroyed first
+	JunctionArena first, second, third;
+
+	// blocks of a reset arena are spare, the next block taken by another arena is the last one returned
+	char *block = static_cast<char*>(first.allocate(64));
+	first.reset();
+	if(second.allocate(64) != block){
+		std::cerr << "ERROR: a block released by reset of an arena is not reused by another arena" << std::endl;
+		return 1;
+	}
+	second.reset();
+
+	// a freed array is handed out again for the same size only
+	void *array = first.allocate(3 * sizeof(Junction));
+	first.deallocate(array, 3 * sizeof(Junction));
+	if(first.allocate(6 * sizeof(Junction)) == array or first.allocate(3 * sizeof(Junction)) != array){
+		std::cerr << "ERROR: a freed array of an arena is not reused by the allocation of its size class" << std::endl;
+		return 1;
+	}
+	first.reset();
+
+	// scopes restore the arena active before them
+	JunctionArena *outside = JunctionArena::active();
+	{
+		JunctionArena::Scope outer(&first);
+		{
+			JunctionArena::Scope inner(&second);
+			if(JunctionArena::active() != &second){
+				std::cerr << "ERROR: the arena of a nested scope is not active" << std::endl;
+				return 1;
+			}
+		}
+		if(JunctionArena::active() != &first){
+			std::cerr << "ERROR: a nested scope does not restore the arena of the outer scope" << std::endl;
+			return 1;
+		}
+	}
+	if(JunctionArena::active() != outside){
+		std::cerr << "ERROR: a scope does not restore the arena active before it" << std::endl;
+		return 1;
+	}
+
+	// a chromosome is allocated in the active arena, a copy in the arena active when copying,
+	// assignment keeps the arena of the assigned chromosome
+	Context context = createTestContext();
+	JunctionArena::Scope scope(&first);
+	ArenaChromosome assigned('A', 50);
+	JunctionArena::Scope alien_scope(&second);
+	ArenaChromosome pure_b('B', 50), alien;
+	pure_b.makeRecombinant(alien, 5, context);
+	if(assigned.getArena() != &first or alien.getArena() != &second){
+		std::cerr << "ERROR: chromosomes are not allocated in the active arena" << std::endl;
+		return 1;
+	}
+	{
+		JunctionArena::Scope copy_scope(&third);
+		ArenaChromosome copy(alien);
+		static_cast<Chromosome&>(assigned) = alien;
+		if(copy.getArena() != &third){
+			std::cerr << "ERROR: a copy of a chromosome is not allocated in the active arena" << std::endl;
+			return 1;
+		}
+		if(assigned.getArena() != &first){
+			std::cerr << "ERROR: copy assignment of a chromosome changed the arena of its junctions" << std::endl;
+			return 1;
+		}
+		for(int locus = 0; locus < 50; locus++){
+			if(assigned.read(locus) != alien.read(locus) or copy.read(locus) != alien.read(locus)){
+				std::cerr << "ERROR: copy of a chromosome differs at locus " << locus << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
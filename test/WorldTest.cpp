@@ -26,6 +26,7 @@ SimulationSetting createSimulationSetting () {
 	setting.deme_size = 64;
 
 	setting.seed = RANDOM_SEED;
+	setting.threads = 1;
 	return setting;
 }
 
@@ -58,3 +59,116 @@ int testWorld(){
 
 	return 0;
 }
+
+// 0D pool of migrants of one origin per generation, the pool is weighted or of individuals
+SimulationSetting createZeroDSetting(std::string type_of_pool, int seed) {
+	SimulationSetting setting = createSimulationSetting();
+	setting.up_down_demes = 1;
+	setting.left_right_demes = 1;
+	setting.dimension = 0;
+	setting.edges_per_deme = 0;
+	setting.selection = 0.2;
+	setting.lambda = 0.5; // a third of gametes are inherited copies
+	setting.loci = 64;
+	setting.selected_loci = 64;
+	setting.chromosomes = 1;
+	setting.deme_size = 100;
+	setting.type_of_pool = type_of_pool;
+	setting.seed = seed;
+	return setting;
+}
+
+int testZeroDPool(){
+	Context context = createTestContext();
+
+	// pure B imigrants taken from the offspring are merged to one entry of their summed copies
+	Chromosome mixed('A', 10);
+	mixed.write(5, 'B');
+	std::vector<Chromosome> gamete(1, mixed);
+	ImigrantPool offspring, pool;
+	offspring.push(Imigrant(context, 'B', 1, 10, 1), 3);
+	offspring.push(Imigrant(context, gamete, 1), 2);
+	offspring.push(Imigrant(context, 'B', 1, 10, 1), 4);
+	for(int i = 0; i < offspring.size(); i++){
+		pool.takeMerged(offspring, i);
+	}
+	if(pool.size() != 2 or !pool[0].isPureB() or pool.getCopies(0) != 7 or pool[1].isPureB() or pool.getCopies(1) != 2){
+		std::cerr << "ERROR: pure B imigrants of weighted pool are not merged to one entry" << std::endl;
+		return 1;
+	}
+	pool.clear();
+	offspring.clear();
+	offspring.push(Imigrant(context, 'B', 1, 10, 1), 5);
+	pool.takeMerged(offspring, 0);
+	if(pool.size() != 1 or pool.getCopies(0) != 5){
+		std::cerr << "ERROR: merging of pure B imigrants is not reset when the pool is cleared" << std::endl;
+		return 1;
+	}
+
+	// offspring counts (Poisson of both mating attempts of all copies), inherited copies (Binomial)
+	// and gametes drawn until they are not copies make the weighted pool a model of the same population
+	// as the pool of individuals, sizes and B material of both agree over replicates
+	const int replicates = 30, generations = 6;
+	double size_sum[2] = {0, 0}, size_squares[2] = {0, 0}, material_sum[2] = {0, 0}, material_squares[2] = {0, 0};
+	std::string types[2] = {"individuals", "weighted"};
+	for(int type = 0; type < 2; type++){
+		for(int replicate = 0; replicate < replicates; replicate++){
+			World world(createZeroDSetting(types[type], RANDOM_SEED + replicate));
+			world.restart();
+			for(int generation = 0; generation < generations; generation++){
+				world.migration();
+				world.globalBreeding();
+			}
+			size_sum[type] += world.getNumberOfIndividuals();
+			size_squares[type] += pow(world.getNumberOfIndividuals(), 2);
+			material_sum[type] += world.getMaterial();
+			material_squares[type] += pow(world.getMaterial(), 2);
+		}
+	}
+	// difference of means within 4 standard errors
+	auto differ = [replicates](double sum[2], double squares[2]){
+		double variance = 0;
+		for(int type = 0; type < 2; type++){
+			variance += (squares[type] - sum[type] * sum[type] / replicates) / (replicates - 1) / replicates;
+		}
+		return std::abs(sum[0] - sum[1]) / replicates > 4 * sqrt(variance);
+	};
+	if(differ(size_sum, size_squares) or differ(material_sum, material_squares)){
+		std::cerr << "ERROR: weighted 0D pool differs from the pool of individuals, mean sizes "
+			<< size_sum[0] / replicates << " and " << size_sum[1] / replicates << ", mean B material "
+			<< material_sum[0] / replicates << " and " << material_sum[1] / replicates << std::endl;
+		return 1;
+	}
+
+	// a pool of several chunks (of 1024 imigrants) is bred by chunks of own generators merged in order,
+	// the pool does not depend on the number of threads
+	for(int type = 0; type < 2; type++){
+		double size[2], material[2], junctions[2];
+		int threads[2] = {1, 4};
+		for(int run = 0; run < 2; run++){
+			SimulationSetting setting = createZeroDSetting(types[type], RANDOM_SEED);
+			setting.deme_size = 1000;
+			setting.threads = threads[run];
+			World world(setting);
+			world.restart();
+			for(int generation = 0; generation < generations; generation++){
+				world.migration();
+				world.globalBreeding();
+			}
+			size[run] = world.getNumberOfIndividuals();
+			material[run] = world.getMaterial();
+			junctions[run] = world.getMeanNumberOfJunctions();
+		}
+		if(type == 0 and size[0] <= 2 * 1024){
+			std::cerr << "ERROR: 0D pool of " << size[0] << " imigrants does not span several chunks" << std::endl;
+			return 1;
+		}
+		if(size[0] != size[1] or material[0] != material[1] or junctions[0] != junctions[1]){
+			std::cerr << "ERROR: " << types[type] << " 0D pool bred by 1 and 4 threads differs, sizes "
+				<< size[0] << " and " << size[1] << ", B material " << material[0] << " and " << material[1]
+				<< ", mean junctions " << junctions[0] << " and " << junctions[1] << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -2,6 +2,7 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 #include "../include/RandomGenerators.h"
 #include "../include/Chromosome.h"
@@ -21,6 +22,7 @@ Context createTestContext() {
 	return Context(RANDOM_SEED);
 }
 
+#include "JunctionArenaTest.cpp"
 #include "ChromosomeTest.cpp"
 #include "ImigrantTest.cpp"
 #include "IndividualTest.cpp"
@@ -41,11 +43,13 @@ int main(int argc, char* argv[]){
 			std::cerr << name << ": HAD A PROBLEM!\n";
 		}
 	};
+	runTest(&testJunctionArena, "Junction arena");
 	runTest(&testChromosome, "Chromosome");
 //	runTest(&testImigrant, "Imigrant");
 	runTest(&testIndividual, "Individual");
 	runTest(&testDeme, "Deme");
 	runTest(&testWorld, "World");
+	runTest(&testZeroDPool, "0D pool");
 	runTest(&testParameterLoading, "Parameter loading");
 
 	if(test_result == 0){